@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// AOTLoader.h
+// -----------------------------------------------------------------------------
+//
+// Loader for modules compiled ahead of time.
+//
+// `ModelRunner::compileToSharedLibrary` emits a shared library with the
+// `_mlir_ciface_` entry points of a module and their packed interface
+// functions. The AOTModule below binds them with dlopen/dlsym only. This header
+// depends on neither LLVM nor MLIR libraries, so binaries that call kernels
+// tuned offline do not need to link the JIT.
+//
+// Usage:
+// ======
+//
+// ```
+// // Offline: compile the module.
+// ModelRunner runner(modelBuilder.getModuleRef());
+// llvm::Error error =
+//     runner.compileToSharedLibrary(CompilationOptions(), "model.so");
+//
+// // At runtime: load the library and call the function named `funcName`.
+// std::string errorMessage;
+// auto aotModule = AOTModule::load("model.so", &errorMessage);
+// bool found = aotModule->invoke(funcName, inputBuffer, outputBuffer);
+// ```
+
+#ifndef IREE_LLVM_SANDBOX_MODELBUILDER_AOTLOADER_H_
+#define IREE_LLVM_SANDBOX_MODELBUILDER_AOTLOADER_H_
+
+#include <dlfcn.h>
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include "mlir/ExecutionEngine/CRunnerUtils.h"
+
+namespace mlir {
+
+class AOTModule {
+ public:
+  // Signature of the functions that take the arguments of an `_mlir_ciface_`
+  // adapter packed into a void** array.
+  using PackedFunction = void (*)(void **);
+
+  // Load the shared library at `path`. Return nullptr and set `errorMessage`,
+  // if given, when the library cannot be loaded.
+  static std::unique_ptr<AOTModule> load(const std::string &path,
+                                         std::string *errorMessage = nullptr) {
+    void *handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+      if (errorMessage) *errorMessage = ::dlerror();
+      return nullptr;
+    }
+    return std::unique_ptr<AOTModule>(new AOTModule(handle));
+  }
+
+  ~AOTModule() { ::dlclose(handle); }
+  AOTModule(const AOTModule &) = delete;
+  AOTModule &operator=(const AOTModule &) = delete;
+
+  // Return the packed interface function of the `_mlir_ciface_` adapter of
+  // `funcName`, or nullptr if the library does not define it.
+  PackedFunction lookupPacked(const std::string &funcName) const {
+    const std::string packedName = "_mlir__mlir_ciface_" + funcName;
+    return reinterpret_cast<PackedFunction>(
+        ::dlsym(handle, packedName.c_str()));
+  }
+
+  // Indirect invocation where the caller sets up the proper indirect pointers
+  // and passes a void** `args` parameter. Return false if `funcName` is not
+  // defined.
+  bool invokeIndirect(const std::string &funcName, void **args) const {
+    PackedFunction packedFunction = lookupPacked(funcName);
+    if (!packedFunction) return false;
+    packedFunction(args);
+    return true;
+  }
+
+  // Direct invocation based on MemRefType which automatically packs the data.
+  // Return false if `funcName` is not defined.
+  template <typename... Args>
+  bool invoke(const std::string &funcName, Args &...args) const {
+    PackedFunction packedFunction = lookupPacked(funcName);
+    if (!packedFunction) return false;
+    void *argsArray[] = {getData(args)...};
+    std::array<void *, sizeof...(Args)> argsArray2;
+    for (unsigned i = 0; i < sizeof...(Args); ++i)
+      argsArray2[i] = &argsArray[i];
+    packedFunction(argsArray2.data());
+    return true;
+  }
+
+ private:
+  explicit AOTModule(void *handle) : handle(handle) {}
+
+  // Get the underlying data for a StridedMemRefType wrapped in a unique_ptr.
+  template <typename T, typename Fun, int U>
+  static void *getData(std::unique_ptr<StridedMemRefType<T, U>, Fun> &arg) {
+    return arg.get();
+  }
+  // Get the underlying data for an UnrankedMemRefType wrapped in a unique_ptr.
+  template <typename T, typename Fun>
+  static void *getData(std::unique_ptr<::UnrankedMemRefType<T>, Fun> &arg) {
+    return arg->descriptor;
+  }
+
+  void *handle;
+};
+
+}  // namespace mlir
+
+#endif  // IREE_LLVM_SANDBOX_MODELBUILDER_AOTLOADER_H_
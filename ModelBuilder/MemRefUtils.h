@@ -31,14 +31,38 @@
 //  void *packedArgs[2] = {&inputBuffer->descriptor, &outputBuffer->descriptor};
 //  runner.engine->invoke(funcName, llvm::MutableArrayRef<void *>{packedArgs});
 // ```
+//
+// Buffers default to ::malloc. Large buffers may instead be backed by huge
+// pages and/or bound to the local NUMA node with `allocHugePages`,
+// `allocNumaLocal` or `allocHugePagesNumaLocal`, and freed with `FreeMemRef`.
+// A `MemRefPool` recycles buffers and descriptors across invocations:
+//
+// ```
+//  MemRefPool pool;
+//  auto buffer = makeInitializedStridedMemRefDescriptor<float, 2,
+//                                                       MemRefPool::Deleter>(
+//      {B, W0}, inputLinearInit, llvm::None, pool.allocator(), pool.deleter());
+// ```
 
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#include <unistd.h>
+
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/ExecutionEngine/CRunnerUtils.h"
 
 #ifndef IREE_LLVM_SANDBOX_MODELBUILDER_MEMREFUTILS_H_
@@ -155,12 +179,160 @@ void freeUnrankedDescriptor(::UnrankedMemRefType<T> *desc) {
   free(desc);
 }
 
+// Allocates `size` bytes aligned to and rounded up to `pageSize`. On Linux, the
+// pages are optionally advised to be backed by transparent huge pages and/or
+// bound to the NUMA node of the calling thread. Bound pages are touched before
+// returning so that they are placed by the calling thread. Allocations smaller
+// than a page use ::malloc. The result is freed with ::free.
+inline void *allocPages(size_t size, size_t pageSize, bool hugePages,
+                        bool numaLocal) {
+  if (size < pageSize) return ::malloc(size);
+  size_t roundedSize = llvm::alignTo(size, pageSize);
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, pageSize, roundedSize) != 0) return nullptr;
+#ifdef __linux__
+  if (hugePages) madvise(ptr, roundedSize, MADV_HUGEPAGE);
+  // MPOL_PREFERRED with an empty node mask prefers the local node, and
+  // MPOL_MF_MOVE migrates the pages the heap already placed on another node.
+  if (numaLocal)
+    syscall(SYS_mbind, ptr, roundedSize, MPOL_PREFERRED, nullptr, 0,
+            MPOL_MF_MOVE);
+#endif
+  if (numaLocal)
+    for (size_t offset = 0; offset < roundedSize; offset += pageSize)
+      static_cast<volatile char *>(ptr)[offset] = 0;
+  return ptr;
+}
+
 }  // namespace detail
 
 //===----------------------------------------------------------------------===//
 // Public API
 //===----------------------------------------------------------------------===//
 
+// Size of the transparent huge pages on x86-64 and AArch64 Linux.
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Allocates buffers of at least `kHugePageSize` bytes on 2MB transparent huge
+// pages to reduce TLB misses. Smaller allocations, e.g. descriptors, use
+// ::malloc. Free with ::free or `FreeMemRef`.
+inline void *allocHugePages(size_t size) {
+  return detail::allocPages(size, kHugePageSize, /*hugePages=*/true,
+                            /*numaLocal=*/false);
+}
+
+// Allocates buffers of at least one page on the NUMA node of the calling
+// thread, which should be the thread that runs the kernel. Smaller allocations
+// use ::malloc. Free with ::free or `FreeMemRef`.
+inline void *allocNumaLocal(size_t size) {
+  return detail::allocPages(size, sysconf(_SC_PAGESIZE), /*hugePages=*/false,
+                            /*numaLocal=*/true);
+}
+
+// Combination of `allocHugePages` and `allocNumaLocal`.
+inline void *allocHugePagesNumaLocal(size_t size) {
+  return detail::allocPages(size, kHugePageSize, /*hugePages=*/true,
+                            /*numaLocal=*/true);
+}
+
+// Deleter that frees both the buffer and the descriptor of a memref allocated
+// with ::malloc or one of the allocators above. The default ::free deleter
+// only frees the descriptor.
+struct FreeMemRef {
+  template <typename T, int N>
+  void operator()(StridedMemRefType<T, N> *descriptor) const {
+    ::free(descriptor->basePtr);
+    ::free(descriptor);
+  }
+  template <typename T>
+  void operator()(::UnrankedMemRefType<T> *descriptor) const {
+    auto *ranked =
+        static_cast<StridedMemRefType<T, 0> *>(descriptor->descriptor);
+    ::free(ranked->basePtr);
+    ::free(ranked);
+    ::free(descriptor);
+  }
+};
+
+// Thread-safe pool that recycles buffers and descriptors across invocations.
+// Allocations are rounded up to a power of two size class and served from the
+// free list of that class, or from `allocFun` when the list is empty. The size
+// class of every block is kept on the side, so blocks are returned exactly as
+// `allocFun` allocated them and keep its alignment, e.g. the huge page
+// alignment of `allocHugePages`. Memory only returns to `allocFun`'s heap,
+// with `freeFun`, when the pool is destroyed, so the pool must outlive the
+// memrefs allocated from it.
+class MemRefPool {
+ public:
+  explicit MemRefPool(AllocFunType allocFun = &::malloc,
+                      std::function<void(void *)> freeFun = &::free)
+      : allocFun(std::move(allocFun)), freeFun(std::move(freeFun)) {}
+  MemRefPool(const MemRefPool &) = delete;
+  MemRefPool &operator=(const MemRefPool &) = delete;
+  ~MemRefPool() {
+    for (auto &it : sizeClasses) freeFun(it.first);
+  }
+
+  void *allocate(size_t size) {
+    unsigned sizeClass = llvm::Log2_64_Ceil(std::max<size_t>(size, 1));
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::vector<void *> &freeList = freeLists[sizeClass];
+      if (!freeList.empty()) {
+        void *ptr = freeList.back();
+        freeList.pop_back();
+        return ptr;
+      }
+    }
+    void *block = allocFun(size_t(1) << sizeClass);
+    if (!block) return nullptr;
+    std::lock_guard<std::mutex> lock(mutex);
+    sizeClasses[block] = sizeClass;
+    return block;
+  }
+
+  void deallocate(void *ptr) {
+    if (!ptr) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sizeClasses.find(ptr);
+    assert(it != sizeClasses.end() && "pointer not allocated by this pool");
+    freeLists[it->second].push_back(ptr);
+  }
+
+  // AllocFunType that allocates from this pool.
+  AllocFunType allocator() {
+    return [this](size_t size) { return allocate(size); };
+  }
+
+  // Deleter that returns the buffer and the descriptor of a memref allocated
+  // with `allocator()` to the pool.
+  struct Deleter {
+    MemRefPool *pool;
+    template <typename T, int N>
+    void operator()(StridedMemRefType<T, N> *descriptor) const {
+      pool->deallocate(descriptor->basePtr);
+      pool->deallocate(descriptor);
+    }
+    template <typename T>
+    void operator()(::UnrankedMemRefType<T> *descriptor) const {
+      auto *ranked =
+          static_cast<StridedMemRefType<T, 0> *>(descriptor->descriptor);
+      pool->deallocate(ranked->basePtr);
+      pool->deallocate(ranked);
+      pool->deallocate(descriptor);
+    }
+  };
+  Deleter deleter() { return Deleter{this}; }
+
+ private:
+  AllocFunType allocFun;
+  std::function<void(void *)> freeFun;
+  std::mutex mutex;
+  std::vector<void *> freeLists[64];
+  // Size class of every block allocated with `allocFun`.
+  llvm::DenseMap<void *, unsigned> sizeClasses;
+};
+
 // Inefficient initializer called on each element during
 // `makeInitializedUnrankedDescriptor`. Takes the linear index and the shape so
 // that it can work in a generic fashion. The user can capture the shape and
@@ -25,6 +25,9 @@
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/TypeUtilities.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/MC/SubtargetFeature.h"
+#include "llvm/Support/Host.h"
 
 using namespace mlir;
 using namespace mlir::edsc;
@@ -377,6 +380,20 @@ MLIRFuncOpConfig &MLIRFuncOpConfig::setTargetCpu(StringRef s) {
   targetCpu = std::string(s);
   return *this;
 }
+MLIRFuncOpConfig &MLIRFuncOpConfig::setTargetFeatures(StringRef s) {
+  targetFeatures = std::string(s);
+  return *this;
+}
+MLIRFuncOpConfig &MLIRFuncOpConfig::setHostTarget() {
+  targetCpu = std::string(llvm::sys::getHostCPUName());
+  llvm::SubtargetFeatures features;
+  llvm::StringMap<bool> hostFeatures;
+  if (llvm::sys::getHostCPUFeatures(hostFeatures))
+    for (auto &feature : hostFeatures)
+      features.AddFeature(feature.first(), feature.second);
+  targetFeatures = features.getString();
+  return *this;
+}
 MLIRFuncOpConfig &MLIRFuncOpConfig::setDeclOnly(bool v) {
   declOnly = v;
   return *this;
@@ -390,13 +407,22 @@ void MLIRFuncOpConfig::apply(FuncOp &f) {
   MLIRContext *ctx = f.getContext();
   SmallVector<Attribute, 8> attrs;
   if (noInline) attrs.push_back(StringAttr::get(ctx, "noinline"));
-  if (preferAvx512)
+  // Do not request 512-bit vectors from a target that does not have them.
+  SmallVector<StringRef, 32> features;
+  StringRef(targetFeatures).split(features, ',');
+  bool hasAvx512 =
+      targetFeatures.empty() || llvm::is_contained(features, "+avx512f");
+  if (preferAvx512 && hasAvx512)
     attrs.push_back(
         ArrayAttr::get(ctx, {StringAttr::get(ctx, "prefer-vector-width"),
                              StringAttr::get(ctx, "512")}));
   if (!targetCpu.empty())
     attrs.push_back(ArrayAttr::get(ctx, {StringAttr::get(ctx, "target-cpu"),
                                          StringAttr::get(ctx, targetCpu)}));
+  if (!targetFeatures.empty())
+    attrs.push_back(
+        ArrayAttr::get(ctx, {StringAttr::get(ctx, "target-features"),
+                             StringAttr::get(ctx, targetFeatures)}));
   if (!attrs.empty()) f->setAttr("passthrough", ArrayAttr::get(ctx, attrs));
 
   if (emitCInterface)
@@ -830,6 +830,14 @@ struct MLIRFuncOpConfig {
   std::string targetCpu = "";
   MLIRFuncOpConfig &setTargetCpu(StringRef s);
 
+  // Comma-separated list of LLVM target features, e.g. "+avx2,+fma".
+  std::string targetFeatures = "";
+  MLIRFuncOpConfig &setTargetFeatures(StringRef s);
+
+  // Sets `targetCpu` and `targetFeatures` to those of the host. A preferred
+  // 512-bit vector width is then only requested if the host has AVX-512.
+  MLIRFuncOpConfig &setHostTarget();
+
   // When true, the function remains body-less. This is good for declaring
   // external functions.
   bool declOnly = false;
@@ -8,7 +8,28 @@
 
 #include "ModelBuilder/ModelRunner.h"
 
+#include <chrono>
+#include <mutex>
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ExecutionEngine/JITEventListener.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Object/SymbolSize.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Target/TargetMachine.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
 #include "mlir/Conversion/GPUToSPIRV/GPUToSPIRVPass.h"
 #include "mlir/Conversion/GPUToVulkan/ConvertGPUToVulkanPass.h"
@@ -21,15 +42,17 @@
 #include "mlir/Conversion/VectorToLLVM/ConvertVectorToLLVM.h"
 #include "mlir/Conversion/VectorToSCF/VectorToSCF.h"
 #include "mlir/Dialect/GPU/Passes.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/Linalg/Passes.h"
 #include "mlir/Dialect/MemRef/Transforms/Passes.h"
 #include "mlir/Dialect/SPIRV/IR/SPIRVOps.h"
 #include "mlir/Dialect/SPIRV/Transforms/Passes.h"
-#include "mlir/ExecutionEngine/ExecutionEngine.h"
 #include "mlir/ExecutionEngine/OptUtils.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassInstrumentation.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Target/LLVMIR/Export.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "mlir/Transforms/Passes.h"
 
@@ -37,6 +60,12 @@ static llvm::cl::opt<bool> mlirDebug(
     "mlir-debug", llvm::cl::desc("Single thread and print-ir-after-all"),
     llvm::cl::init(false));
 
+static llvm::cl::opt<std::string> compileTimingsFile(
+    "compile-timings",
+    llvm::cl::desc("Append the JSON compile time breakdown of every "
+                   "compilation to this file, '-' for stdout"),
+    llvm::cl::value_desc("filename"), llvm::cl::init(""));
+
 struct LLVMInitializer {
   LLVMInitializer() {
     llvm::InitializeNativeTarget();
@@ -49,10 +78,252 @@ namespace llvm {
 extern Pass* createLowerMatrixIntrinsicsPass();
 }  // end namespace llvm
 
-void mlir::ModelRunner::compile(
-    CompilationOptions compilationOptions,
-    llvm::ArrayRef<const std::string> runtime,
-    llvm::ArrayRef<std::pair<std::string, void*>> extra_symbols) {
+// Return the name of the function that takes the arguments of `name` packed
+// into a void** array.
+static std::string makePackedFunctionName(StringRef name) {
+  return "_mlir_" + name.str();
+}
+
+// For each function in the LLVM module, define an interface function that
+// wraps all the arguments of the original function and all its results into
+// an i8** pointer to provide a unified invocation interface. This mirrors the
+// interface functions created by mlir::ExecutionEngine.
+static void packFunctionArguments(llvm::Module* module) {
+  auto& ctx = module->getContext();
+  llvm::IRBuilder<> builder(ctx);
+  DenseSet<llvm::Function*> interfaceFunctions;
+  for (auto& func : module->getFunctionList()) {
+    if (func.isDeclaration()) continue;
+    if (interfaceFunctions.count(&func)) continue;
+
+    // Given a function `foo(<...>)`, define the interface function
+    // `_mlir_foo(i8**)`.
+    auto newType = llvm::FunctionType::get(
+        builder.getVoidTy(), builder.getInt8PtrTy()->getPointerTo(),
+        /*isVarArg=*/false);
+    auto newName = makePackedFunctionName(func.getName());
+    auto funcCst = module->getOrInsertFunction(newName, newType);
+    llvm::Function* interfaceFunc = cast<llvm::Function>(funcCst.getCallee());
+    interfaceFunctions.insert(interfaceFunc);
+
+    // Extract the arguments from the type-erased argument list and cast them
+    // to the proper types.
+    auto bb = llvm::BasicBlock::Create(ctx);
+    bb->insertInto(interfaceFunc);
+    builder.SetInsertPoint(bb);
+    llvm::Value* argList = interfaceFunc->arg_begin();
+    SmallVector<llvm::Value*, 8> args;
+    args.reserve(llvm::size(func.args()));
+    for (auto& indexedArg : llvm::enumerate(func.args())) {
+      llvm::Value* argIndex = llvm::Constant::getIntegerValue(
+          builder.getInt64Ty(), APInt(64, indexedArg.index()));
+      llvm::Value* argPtrPtr =
+          builder.CreateGEP(builder.getInt8PtrTy(), argList, argIndex);
+      llvm::Value* argPtr =
+          builder.CreateLoad(builder.getInt8PtrTy(), argPtrPtr);
+      llvm::Type* argTy = indexedArg.value().getType();
+      argPtr = builder.CreateBitCast(argPtr, argTy->getPointerTo());
+      args.push_back(builder.CreateLoad(argTy, argPtr));
+    }
+
+    // Call the implementation function with the extracted arguments.
+    llvm::Value* result = builder.CreateCall(&func, args);
+
+    // Assuming the result is one value, potentially of type `void`.
+    if (!result->getType()->isVoidTy()) {
+      llvm::Value* retIndex = llvm::Constant::getIntegerValue(
+          builder.getInt64Ty(), APInt(64, llvm::size(func.args())));
+      llvm::Value* retPtrPtr =
+          builder.CreateGEP(builder.getInt8PtrTy(), argList, retIndex);
+      llvm::Value* retPtr =
+          builder.CreateLoad(builder.getInt8PtrTy(), retPtrPtr);
+      retPtr = builder.CreateBitCast(retPtr, result->getType()->getPointerTo());
+      builder.CreateStore(result, retPtr);
+    }
+
+    // The interface function returns void.
+    builder.CreateRetVoid();
+  }
+}
+
+// Return the key of the object compiled from `module`: a hash of the lowered
+// module, the target triple, the CPU name and features and the optimization
+// levels.
+static std::string getObjectKey(ModuleOp module,
+                                llvm::TargetMachine& targetMachine,
+                                const CompilationOptions& options) {
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << targetMachine.getTargetTriple().getTriple() << "\n"
+     << targetMachine.getTargetCPU() << "\n"
+     << targetMachine.getTargetFeatureString() << "\n"
+     << options.llvmOptLevel << " " << targetMachine.getOptLevel() << "\n";
+  module.print(os);
+  os.flush();
+  return llvm::toHex(llvm::SHA1::hash(llvm::arrayRefFromStringRef(key)),
+                     /*LowerCase=*/true);
+}
+
+namespace {
+// Appends the address, size and name of the functions of every object loaded
+// by a JIT to /tmp/perf-<pid>.map. `perf report` and `perf annotate` read the
+// map to attribute samples in JIT-compiled code, without `perf inject`.
+class PerfMapEventListener : public llvm::JITEventListener {
+ public:
+  static PerfMapEventListener& get() {
+    static PerfMapEventListener listener;
+    return listener;
+  }
+
+  void notifyObjectLoaded(
+      ObjectKey key, const llvm::object::ObjectFile& object,
+      const llvm::RuntimeDyld::LoadedObjectInfo& loadedObjectInfo) override {
+    if (!perfMap) return;
+    // The debug object has its sections relocated at their load addresses.
+    llvm::object::OwningBinary<llvm::object::ObjectFile> debugObject =
+        loadedObjectInfo.getObjectForDebug(object);
+    if (!debugObject.getBinary()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& symbolAndSize :
+         llvm::object::computeSymbolSizes(*debugObject.getBinary())) {
+      const llvm::object::SymbolRef& symbol = symbolAndSize.first;
+      auto type = symbol.getType();
+      auto name = symbol.getName();
+      auto address = symbol.getAddress();
+      if (!type || !name || !address) {
+        llvm::consumeError(type.takeError());
+        llvm::consumeError(name.takeError());
+        llvm::consumeError(address.takeError());
+        continue;
+      }
+      if (*type != llvm::object::SymbolRef::ST_Function) continue;
+      *perfMap << llvm::format_hex_no_prefix(*address, 1) << " "
+               << llvm::format_hex_no_prefix(symbolAndSize.second, 1) << " "
+               << *name << "\n";
+    }
+    perfMap->flush();
+  }
+
+ private:
+  PerfMapEventListener() {
+    std::string path =
+        "/tmp/perf-" + std::to_string(llvm::sys::Process::getProcessId()) +
+        ".map";
+    std::error_code ec;
+    perfMap = std::make_unique<llvm::raw_fd_ostream>(
+        path, ec, llvm::sys::fs::OF_Append | llvm::sys::fs::OF_Text);
+    if (ec) {
+      llvm::errs() << "could not open " << path << ": " << ec.message()
+                   << "\n";
+      perfMap.reset();
+    }
+  }
+
+  std::mutex mutex;
+  std::unique_ptr<llvm::raw_fd_ostream> perfMap;
+};
+
+// Adds the wall-clock seconds between its construction and destruction to
+// `seconds`.
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(double& seconds)
+      : seconds(seconds), start(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() {
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                             start)
+                   .count();
+  }
+
+ private:
+  double& seconds;
+  std::chrono::steady_clock::time_point start;
+};
+
+// Accumulates the wall-clock time of every pass, by pass argument, into the
+// `mlirPasses` of `timings`. Passes without an argument, e.g. the adaptors of
+// nested pass managers, are not reported.
+class PassTimingInstrumentation : public mlir::PassInstrumentation {
+ public:
+  explicit PassTimingInstrumentation(mlir::CompileTimings& timings)
+      : timings(timings) {}
+
+  void runBeforePass(mlir::Pass* pass, mlir::Operation* op) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    startTimes[{pass, op}] = std::chrono::steady_clock::now();
+  }
+  void runAfterPass(mlir::Pass* pass, mlir::Operation* op) override {
+    record(pass, op);
+  }
+  void runAfterPassFailed(mlir::Pass* pass, mlir::Operation* op) override {
+    record(pass, op);
+  }
+
+ private:
+  void record(mlir::Pass* pass, mlir::Operation* op) {
+    auto end = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = startTimes.find({pass, op});
+    if (it == startTimes.end()) return;
+    double seconds = std::chrono::duration<double>(end - it->second).count();
+    startTimes.erase(it);
+    llvm::StringRef name = pass->getArgument();
+    if (name.empty()) return;
+    auto inserted = passIndices.try_emplace(name, timings.mlirPasses.size());
+    if (inserted.second) timings.mlirPasses.emplace_back(name.str(), 0.0);
+    timings.mlirPasses[inserted.first->second].second += seconds;
+  }
+
+  mlir::CompileTimings& timings;
+  std::mutex mutex;
+  llvm::DenseMap<std::pair<mlir::Pass*, mlir::Operation*>,
+                 std::chrono::steady_clock::time_point>
+      startTimes;
+  llvm::StringMap<unsigned> passIndices;
+};
+}  // namespace
+
+// Append `timings` as one line of JSON to the file of the `compile-timings`
+// flag, if any.
+static void emitCompileTimings(const mlir::CompileTimings& timings) {
+  if (compileTimingsFile.empty()) return;
+  if (compileTimingsFile == "-") {
+    timings.printJSON(llvm::outs());
+    llvm::outs() << "\n";
+    return;
+  }
+  std::error_code ec;
+  llvm::raw_fd_ostream os(compileTimingsFile, ec,
+                          llvm::sys::fs::OF_Append | llvm::sys::fs::OF_Text);
+  if (ec) {
+    llvm::errs() << "could not open " << compileTimingsFile << ": "
+                 << ec.message() << "\n";
+    return;
+  }
+  timings.printJSON(os);
+  os << "\n";
+}
+
+void mlir::CompileTimings::printJSON(llvm::raw_ostream& os) const {
+  llvm::json::OStream json(os);
+  json.object([&] {
+    json.attribute("mlir_lowering_s", mlirLowering);
+    json.attributeArray("mlir_passes", [&] {
+      for (const auto& pass : mlirPasses)
+        json.object([&] {
+          json.attribute("name", pass.first);
+          json.attribute("seconds", pass.second);
+        });
+    });
+    json.attribute("llvm_translation_s", llvmTranslation);
+    json.attribute("llvm_optimization_s", llvmOptimization);
+    json.attribute("codegen_s", codegen);
+    json.attribute("total_s", getTotal());
+  });
+}
+
+void mlir::ModelRunner::lowerToLLVMDialect(
+    const CompilationOptions& compilationOptions) {
   if (target == Target::CPUTarget) {
     // Lower vector operations progressively into more elementary
     // vector operations before running the regular compiler passes.
@@ -66,23 +337,26 @@ void mlir::ModelRunner::compile(
   runLoweringPass(compilationOptions.loweringPasses
                       ? compilationOptions.loweringPasses
                       : getDefaultMLIRPassBuilder());
+}
 
-  // Make sure the execution engine runs LLVM passes for the specified
-  // optimization level.
-  auto tmBuilderOrError = llvm::orc::JITTargetMachineBuilder::detectHost();
-  if (!tmBuilderOrError) {
-    llvm::errs() << tmBuilderOrError.takeError() << "\n";
-    return;
-  }
-  auto t = tmBuilderOrError->getTargetTriple().getTriple();
-  auto tmOrError = tmBuilderOrError->createTargetMachine();
-  if (!tmOrError) {
-    llvm::errs() << tmOrError.takeError() << "\n";
-    return;
-  }
-  targetMachine = std::move(tmOrError.get());
+// Create a target machine for `tmBuilder` at the llc optimization level of
+// `compilationOptions`.
+static llvm::Expected<std::unique_ptr<llvm::TargetMachine>>
+createTargetMachine(llvm::orc::JITTargetMachineBuilder& tmBuilder,
+                    const CompilationOptions& compilationOptions) {
+  tmBuilder.setCodeGenOptLevel(
+      static_cast<llvm::CodeGenOpt::Level>(compilationOptions.llcOptLevel));
+  return tmBuilder.createTargetMachine();
+}
+
+// Return a transformer that optimizes LLVM modules at `llvmOptLevel` for
+// `targetMachine`, lowering matrix intrinsics for CPU targets.
+static std::function<llvm::Error(llvm::Module*)> makeOptimizingTransformer(
+    unsigned llvmOptLevel, llvm::TargetMachine* targetMachine,
+    bool lowerMatrixIntrinsics) {
+  // Make sure LLVM runs the passes for the specified optimization level.
   SmallVector<const llvm::PassInfo*, 4> llvmPasses;
-  if (target == Target::CPUTarget) {
+  if (lowerMatrixIntrinsics) {
     // TODO(ntv): Looking up the pass by name fails quite surprisingly. Just
     // build the pass to get its ID to look up the PassInfo.
     std::unique_ptr<llvm::Pass> owningLowerMatrixIntrinsicsPass(
@@ -92,39 +366,334 @@ void mlir::ModelRunner::compile(
     assert(lowerMatrixIntrinsics);
     llvmPasses.push_back(lowerMatrixIntrinsics);
   }
-  auto transformer = mlir::makeLLVMPassesTransformer(
-      llvmPasses, compilationOptions.llvmOptLevel, targetMachine.get(),
-      /*optPassesInsertPos=*/0);
-
-  // Pass in runtime support library when specified.
-  SmallVector<StringRef, 4> libs(runtime.begin(), runtime.end());
-
-  // Obtain the execution engine.
-  auto created = mlir::ExecutionEngine::create(
-      *module, /*llvmModuleBuilder=*/nullptr, transformer,
-      static_cast<llvm::CodeGenOpt::Level>(compilationOptions.llcOptLevel),
-      libs,
-      /*enableObjectCache=*/true,
-      /*enableGDBNotificationListener=*/false);
-  llvm::handleAllErrors(created.takeError(), [](const llvm::ErrorInfoBase& b) {
-    b.log(llvm::errs());
-    assert(false);
-  });
-  engine = std::move(*created);
+  return mlir::makeLLVMPassesTransformer(llvmPasses, llvmOptLevel,
+                                         targetMachine,
+                                         /*optPassesInsertPos=*/0);
+}
+
+llvm::Expected<std::shared_ptr<mlir::SharedJIT>> mlir::SharedJIT::create(
+    const CompilationOptions& compilationOptions) {
+  std::shared_ptr<SharedJIT> sharedJit(new SharedJIT());
+  auto tmBuilderOrError = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!tmBuilderOrError) return tmBuilderOrError.takeError();
+  llvm::orc::JITTargetMachineBuilder tmBuilder = *tmBuilderOrError;
+  auto tmOrError = createTargetMachine(tmBuilder, compilationOptions);
+  if (!tmOrError) return tmOrError.takeError();
+  sharedJit->targetMachine = std::move(*tmOrError);
+  sharedJit->lazy = compilationOptions.lazyCompilation;
+  if (!compilationOptions.objectCacheDir.empty() && !sharedJit->lazy)
+    sharedJit->objectCache = std::make_unique<PersistentObjectCache>(
+        compilationOptions.objectCacheDir);
+
+  // Objects compiled from IR are written to the object cache. Runners may
+  // compile concurrently, so every compilation uses its own target machine.
+  using IRCompiler = llvm::orc::IRCompileLayer::IRCompiler;
+  PersistentObjectCache* cache = sharedJit->objectCache.get();
+  auto compileFunctionCreator = [cache](llvm::orc::JITTargetMachineBuilder jtmb)
+      -> llvm::Expected<std::unique_ptr<IRCompiler>> {
+    return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb),
+                                                             cache);
+  };
+  // Let perf symbolize JIT-compiled code, through the jitdump files of LLVM's
+  // perf listener when LLVM is built with LLVM_USE_PERF, and through a perf
+  // map otherwise.
+  SmallVector<llvm::JITEventListener*, 2> eventListeners;
+  if (compilationOptions.enablePerfNotificationListener) {
+    if (llvm::JITEventListener* perfListener =
+            llvm::JITEventListener::createPerfJITEventListener())
+      eventListeners.push_back(perfListener);
+    eventListeners.push_back(&PerfMapEventListener::get());
+  }
+  auto objectLinkingLayerCreator = [eventListeners](
+                                       llvm::orc::ExecutionSession& session,
+                                       const llvm::Triple&) {
+    auto getMemoryManager = []() {
+      return std::make_unique<llvm::SectionMemoryManager>();
+    };
+    auto objectLayer = std::make_unique<llvm::orc::RTDyldObjectLinkingLayer>(
+        session, getMemoryManager);
+    for (llvm::JITEventListener* listener : eventListeners)
+      objectLayer->registerJITEventListener(*listener);
+    return objectLayer;
+  };
+  auto configure = [&](auto& jitBuilder) {
+    jitBuilder.setJITTargetMachineBuilder(tmBuilder)
+        .setCompileFunctionCreator(compileFunctionCreator)
+        .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
+        .setNumCompileThreads(compilationOptions.numCompileThreads);
+  };
+  if (!sharedJit->lazy) {
+    llvm::orc::LLJITBuilder jitBuilder;
+    configure(jitBuilder);
+    auto jitOrError = jitBuilder.create();
+    if (!jitOrError) return jitOrError.takeError();
+    sharedJit->jit = std::move(*jitOrError);
+    return sharedJit;
+  }
+
+  llvm::orc::LLLazyJITBuilder jitBuilder;
+  configure(jitBuilder);
+  auto jitOrError = jitBuilder.create();
+  if (!jitOrError) return jitOrError.takeError();
+  // Every function is extracted into its own module on its first call, then
+  // optimized and compiled.
+  auto transformer = makeOptimizingTransformer(
+      compilationOptions.llvmOptLevel, sharedJit->targetMachine.get(),
+      /*lowerMatrixIntrinsics=*/true);
+  (*jitOrError)
+      ->getIRTransformLayer()
+      .setTransform(
+          [transformer](llvm::orc::ThreadSafeModule tsm,
+                        const llvm::orc::MaterializationResponsibility&)
+              -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+            if (llvm::Error error = tsm.withModuleDo(
+                    [&](llvm::Module& m) { return transformer(&m); }))
+              return std::move(error);
+            return std::move(tsm);
+          });
+  sharedJit->jit = std::move(*jitOrError);
+  return sharedJit;
+}
+
+llvm::Expected<llvm::orc::JITDylib&> mlir::SharedJIT::createJITDylib() {
+  return jit->createJITDylib("model_" + std::to_string(numJITDylibs++));
+}
+
+mlir::ModelRunner::~ModelRunner() {
+  // Release the code and symbols of this runner from a JIT shared with other
+  // runners.
+  if (dylib) llvm::consumeError(dylib->clear());
+}
+
+std::unique_ptr<llvm::Module> mlir::ModelRunner::translateToLLVMIR(
+    llvm::TargetMachine& targetMachine, llvm::LLVMContext& llvmContext,
+    StringRef moduleIdentifier) {
+  std::unique_ptr<llvm::Module> llvmModule =
+      translateModuleToLLVMIR(*module, llvmContext);
+  if (!llvmModule) {
+    llvm::errs() << "translation to LLVM IR failed\n";
+    return nullptr;
+  }
+  llvmModule->setModuleIdentifier(moduleIdentifier);
+  llvmModule->setDataLayout(targetMachine.createDataLayout());
+  llvmModule->setTargetTriple(targetMachine.getTargetTriple().getTriple());
+  packFunctionArguments(llvmModule.get());
+  return llvmModule;
+}
+
+void mlir::ModelRunner::compile(
+    CompilationOptions compilationOptions,
+    llvm::ArrayRef<const std::string> runtime,
+    llvm::ArrayRef<std::pair<std::string, void*>> extra_symbols) {
+  compileTimings = CompileTimings();
+  {
+    ScopedTimer timer(compileTimings.mlirLowering);
+    lowerToLLVMDialect(compilationOptions);
+  }
+
+  if (!sharedJit) {
+    auto sharedJitOrError = SharedJIT::create(compilationOptions);
+    if (!sharedJitOrError) {
+      llvm::errs() << sharedJitOrError.takeError() << "\n";
+      return;
+    }
+    sharedJit = std::move(*sharedJitOrError);
+  }
+  llvm::orc::LLJIT& jit = sharedJit->getJIT();
+  llvm::TargetMachine& targetMachine = sharedJit->getTargetMachine();
+  auto dylibOrError = sharedJit->createJITDylib();
+  if (!dylibOrError) {
+    llvm::errs() << dylibOrError.takeError() << "\n";
+    return;
+  }
+  dylib = &*dylibOrError;
+
+  // Look up the object in the persistent cache, keyed on everything that
+  // determines the generated code.
+  std::string objectKey = "LLVMDialectModule";
+  std::unique_ptr<llvm::MemoryBuffer> cachedObject;
+  if (PersistentObjectCache* objectCache = sharedJit->getObjectCache()) {
+    objectKey = getObjectKey(*module, targetMachine, compilationOptions);
+    cachedObject = objectCache->getObject(objectKey);
+  }
+
+  // Resolve symbols from the runtime support libraries and from the current
+  // process.
+  const llvm::DataLayout& dataLayout = jit.getDataLayout();
+  for (const std::string& lib : runtime) {
+    auto generator = llvm::orc::DynamicLibrarySearchGenerator::Load(
+        lib.c_str(), dataLayout.getGlobalPrefix());
+    if (!generator) {
+      llvm::errs() << "could not load " << lib << ": "
+                   << generator.takeError() << "\n";
+      continue;
+    }
+    dylib->addGenerator(std::move(*generator));
+  }
+  dylib->addGenerator(
+      llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::
+                         GetForCurrentProcess(dataLayout.getGlobalPrefix())));
+
+  loadedCachedObject = static_cast<bool>(cachedObject);
+  if (cachedObject) {
+    // The cached object already contains the packed interface functions.
+    llvm::cantFail(jit.addObjectFile(*dylib, std::move(cachedObject)));
+  } else {
+    // Translate to LLVM IR and add the packed interface functions.
+    auto llvmContext = std::make_unique<llvm::LLVMContext>();
+    std::unique_ptr<llvm::Module> llvmModule;
+    {
+      ScopedTimer timer(compileTimings.llvmTranslation);
+      llvmModule = translateToLLVMIR(targetMachine, *llvmContext, objectKey);
+    }
+    if (!llvmModule) return;
+    llvm::orc::ThreadSafeModule tsm(std::move(llvmModule),
+                                    std::move(llvmContext));
+    if (sharedJit->isLazy()) {
+      // The shared JIT optimizes every function on its first call.
+      llvm::cantFail(static_cast<llvm::orc::LLLazyJIT&>(jit).addLazyIRModule(
+          *dylib, std::move(tsm)));
+    } else {
+      auto transformer = makeOptimizingTransformer(
+          compilationOptions.llvmOptLevel, &targetMachine,
+          /*lowerMatrixIntrinsics=*/target == Target::CPUTarget);
+      ScopedTimer timer(compileTimings.llvmOptimization);
+      if (llvm::Error error = tsm.withModuleDo(
+              [&](llvm::Module& m) { return transformer(&m); })) {
+        llvm::errs() << error << "\n";
+        return;
+      }
+      llvm::cantFail(jit.addIRModule(*dylib, std::move(tsm)));
+    }
+  }
 
   // Define any extra symbols so they're available at runtime.
-  auto symbolRegisterer =
-      [&extra_symbols](llvm::orc::MangleAndInterner interner) {
-        llvm::orc::SymbolMap symbolMap;
-        for (auto& symbol : extra_symbols) {
-          const std::string& name = symbol.first;
-          void* function_pointer = symbol.second;
-          symbolMap[interner(name)] =
-              llvm::JITEvaluatedSymbol::fromPointer(function_pointer);
-        }
-        return symbolMap;
-      };
-  engine->registerSymbols(symbolRegisterer);
+  llvm::orc::MangleAndInterner interner(jit.getExecutionSession(),
+                                        dataLayout);
+  llvm::orc::SymbolMap symbolMap;
+  for (auto& symbol : extra_symbols) {
+    const std::string& name = symbol.first;
+    void* function_pointer = symbol.second;
+    symbolMap[interner(name)] =
+        llvm::JITEvaluatedSymbol::fromPointer(function_pointer);
+  }
+  llvm::cantFail(dylib->define(llvm::orc::absoluteSymbols(symbolMap)));
+
+  // Resolve all the entry points once, such that invocations only read
+  // `packedFunctions` and never lock the JIT. This generates and links the
+  // machine code, except in lazy mode where it only resolves the lazy
+  // reexports without compiling the functions.
+  {
+    ScopedTimer timer(compileTimings.codegen);
+    StringRef prefix = "_mlir_ciface_";
+    module->walk([&](LLVM::LLVMFuncOp func) {
+      if (func.isExternal() || !func.getName().startswith(prefix)) return;
+      StringRef funcName = func.getName().drop_front(prefix.size());
+      auto symbol =
+          jit.lookup(*dylib, makePackedFunctionName(func.getName()));
+      if (!symbol) {
+        llvm::errs() << symbol.takeError() << "\n";
+        return;
+      }
+      packedFunctions[funcName] =
+          reinterpret_cast<void (*)(void**)>(symbol->getAddress());
+    });
+  }
+  emitCompileTimings(compileTimings);
+}
+
+llvm::Error mlir::ModelRunner::compileToObjectFile(
+    CompilationOptions compilationOptions, StringRef objectPath) {
+  compileTimings = CompileTimings();
+  {
+    ScopedTimer timer(compileTimings.mlirLowering);
+    lowerToLLVMDialect(compilationOptions);
+  }
+
+  // Objects compiled ahead of time may be linked into shared libraries.
+  auto tmBuilderOrError = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!tmBuilderOrError) return tmBuilderOrError.takeError();
+  tmBuilderOrError->setRelocationModel(llvm::Reloc::PIC_);
+  auto tmOrError = createTargetMachine(*tmBuilderOrError, compilationOptions);
+  if (!tmOrError) return tmOrError.takeError();
+  std::unique_ptr<llvm::TargetMachine> targetMachine = std::move(*tmOrError);
+
+  llvm::LLVMContext llvmContext;
+  std::unique_ptr<llvm::Module> llvmModule;
+  {
+    ScopedTimer timer(compileTimings.llvmTranslation);
+    llvmModule =
+        translateToLLVMIR(*targetMachine, llvmContext, "LLVMDialectModule");
+  }
+  if (!llvmModule)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "translation to LLVM IR failed");
+  {
+    ScopedTimer timer(compileTimings.llvmOptimization);
+    if (llvm::Error error = makeOptimizingTransformer(
+            compilationOptions.llvmOptLevel, targetMachine.get(),
+            /*lowerMatrixIntrinsics=*/target == Target::CPUTarget)(
+            llvmModule.get()))
+      return error;
+  }
+
+  std::error_code ec;
+  llvm::ToolOutputFile objectFile(objectPath, ec, llvm::sys::fs::OF_None);
+  if (ec) return llvm::errorCodeToError(ec);
+  llvm::legacy::PassManager codegenPasses;
+  if (targetMachine->addPassesToEmitFile(codegenPasses, objectFile.os(),
+                                         /*DwoOut=*/nullptr,
+                                         llvm::CGFT_ObjectFile))
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "target cannot emit object files");
+  {
+    ScopedTimer timer(compileTimings.codegen);
+    codegenPasses.run(*llvmModule);
+  }
+  objectFile.keep();
+  emitCompileTimings(compileTimings);
+  return llvm::Error::success();
+}
+
+llvm::Error mlir::ModelRunner::compileToSharedLibrary(
+    CompilationOptions compilationOptions, StringRef libraryPath,
+    llvm::ArrayRef<const std::string> runtime) {
+  SmallString<128> objectPath;
+  if (std::error_code ec =
+          llvm::sys::fs::createTemporaryFile("model", "o", objectPath))
+    return llvm::errorCodeToError(ec);
+  llvm::FileRemover objectRemover(objectPath);
+  if (llvm::Error error = compileToObjectFile(compilationOptions, objectPath))
+    return error;
+
+  // Link with the system compiler driver, which knows the platform defaults.
+  auto linker = llvm::sys::findProgramByName("cc");
+  if (!linker) return llvm::errorCodeToError(linker.getError());
+  SmallVector<StringRef, 8> args = {*linker, "-shared", "-o", libraryPath,
+                                    objectPath};
+  for (const std::string& lib : runtime) args.push_back(lib);
+  std::string errorMessage;
+  if (llvm::sys::ExecuteAndWait(*linker, args, /*Env=*/llvm::None,
+                                /*Redirects=*/{}, /*SecondsToWait=*/0,
+                                /*MemoryLimit=*/0, &errorMessage) != 0)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "linking %s failed: %s",
+                                   libraryPath.str().c_str(),
+                                   errorMessage.c_str());
+  return llvm::Error::success();
+}
+
+llvm::Expected<void (*)(void**)> mlir::ModelRunner::lookupPacked(
+    StringRef funcName) {
+  auto it = packedFunctions.find(funcName);
+  if (it != packedFunctions.end()) return it->second;
+  if (!dylib)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "the module is not compiled");
+  auto symbol = sharedJit->getJIT().lookup(
+      *dylib, makePackedFunctionName("_mlir_ciface_" + funcName.str()));
+  if (!symbol) return symbol.takeError();
+  return reinterpret_cast<void (*)(void**)>(symbol->getAddress());
 }
 
 static void addVulkanLoweringPass(mlir::PassManager& manager) {
@@ -175,6 +744,8 @@ void mlir::ModelRunner::runLoweringPass(
                              [](Pass*, Operation*) { return true; }, true, true,
                              /*printAfterOnlyOnFailure=*/false, llvm::errs());
   }
+  manager.addInstrumentation(
+      std::make_unique<PassTimingInstrumentation>(compileTimings));
   passBuilder(manager);
   if (failed(manager.run(*module))) {
     llvm::errs() << "conversion to the LLVM IR dialect failed\n";
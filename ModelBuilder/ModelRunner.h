@@ -13,8 +13,9 @@
 //
 // The ModelRunner exposes relevant core MLIR and LLVM APIs that are sufficient
 // to compile an mlir::ModuleOp. This set of classes and APIs encompass:
-//  1. an mlir::ExecutionEngine engine
-//  2. and llvm::TargetMachine targetMachine;
+//  1. an llvm::orc::LLJIT jit, optionally backed by a persistent object cache,
+//  and an llvm::TargetMachine, both of which several runners may share;
+//  2. a thread-safe `invoke` that does not lock once the module is compiled;
 //  3. a `compile` function that takes optimization levels for the llvm opt and
 //  llc tools and produces LLVMIR.
 //
@@ -35,18 +36,35 @@
 // auto outputBuffer = ...;
 //
 // // Call the funcOp name `funcName` with arguments.
-// runner.engine->invoke(funcName, ...);
+// runner.invoke(funcName, ...);
+//
+// // Compile another model into the same JIT.
+// ModelRunner otherRunner(otherModelBuilder.getModuleRef(),
+//                         ModelRunner::Target::CPUTarget,
+//                         runner.getSharedJIT());
+//
+// // Or look it up once and call it repeatedly with minimal overhead.
+// auto kernel = runner.lookup(funcName, ...);
+// (*kernel)();
 // ```
 
 #ifndef IREE_LLVM_SANDBOX_MODELBUILDER_MODELRUNNER_H_
 #define IREE_LLVM_SANDBOX_MODELBUILDER_MODELRUNNER_H_
 
+#include <array>
+#include <atomic>
 #include <functional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "ModelBuilder/MemRefUtils.h"
+#include "ModelBuilder/ObjectCache.h"
+#include "ModelBuilder/PerfCounters.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "mlir/Dialect/Vector/VectorTransforms.h"
-#include "mlir/ExecutionEngine/ExecutionEngine.h"
 #include "mlir/IR/BuiltinOps.h"
 
 namespace llvm {
@@ -55,7 +73,8 @@ class TargetMachine;
 
 namespace mlir {
 class PassManager;
-class ExecutionEngine;
+template <typename... Args>
+class KernelHandle;
 
 struct CompilationOptions {
   unsigned llvmOptLevel = 3;
@@ -63,16 +82,92 @@ struct CompilationOptions {
   vector::VectorTransformsOptions vectorTransformsOptions =
       vector::VectorTransformsOptions();
   std::function<void(mlir::PassManager &)> loweringPasses = nullptr;
+  // Directory of the persistent object cache. When set, the compiled object is
+  // keyed by a hash of the lowered module, the target triple, the CPU name and
+  // features and the optimization levels, and a later `compile` of the same
+  // module loads it from disk instead of running LLVM again.
+  std::string objectCacheDir;
+  // Compile every function lazily on its first invocation instead of
+  // compiling the whole module in `compile`. The persistent object cache only
+  // applies to eager compilation.
+  bool lazyCompilation = false;
+  // Number of threads that compile concurrently, e.g. the functions invoked
+  // from different threads in lazy mode. Zero compiles on the calling thread.
+  unsigned numCompileThreads = 0;
+  // Register JIT event listeners that let `perf record`, `perf report` and
+  // `perf annotate` attribute samples to the JIT-compiled functions by name:
+  // LLVM's jitdump listener, if built in, and a /tmp/perf-<pid>.map writer.
+  bool enablePerfNotificationListener = false;
+};
+
+// An LLJIT and the TargetMachine it compiles for, which several ModelRunners
+// may share. Every runner compiles its module into its own JITDylib, such that
+// models may define functions of the same name. The JIT-wide options, i.e. the
+// llc optimization level, `objectCacheDir`, `lazyCompilation`,
+// `numCompileThreads`, `enablePerfNotificationListener` and, in lazy mode, the
+// llvm optimization level, are those passed to `create`.
+class SharedJIT {
+ public:
+  static llvm::Expected<std::shared_ptr<SharedJIT>> create(
+      const CompilationOptions &compilationOptions);
+
+  llvm::orc::LLJIT &getJIT() { return *jit; }
+  llvm::TargetMachine &getTargetMachine() { return *targetMachine; }
+  PersistentObjectCache *getObjectCache() { return objectCache.get(); }
+  bool isLazy() const { return lazy; }
+
+  // Create a new JITDylib with a unique name. Thread-safe.
+  llvm::Expected<llvm::orc::JITDylib &> createJITDylib();
+
+ private:
+  SharedJIT() = default;
+
+  // The target machine must outlive the JIT since it may be used by the
+  // transformation layers. The object cache, if any, must outlive the JIT that
+  // compiles into it.
+  std::unique_ptr<llvm::TargetMachine> targetMachine;
+  std::unique_ptr<PersistentObjectCache> objectCache;
+  std::unique_ptr<llvm::orc::LLJIT> jit;
+  bool lazy = false;
+  std::atomic<unsigned> numJITDylibs{0};
+};
+
+// Wall-clock compile time breakdown of a compilation, in seconds.
+struct CompileTimings {
+  // Lowering to the LLVM dialect, in total and per pass in the order of their
+  // first run. Passes running on several operations in parallel report the sum
+  // over all threads.
+  double mlirLowering = 0.0;
+  std::vector<std::pair<std::string, double>> mlirPasses;
+  // Translation of the LLVM dialect to LLVM IR.
+  double llvmTranslation = 0.0;
+  // LLVM IR optimization, and machine code generation and linking or loading
+  // of the cached object. With a lazy JIT, both happen per function on its
+  // first call instead and are not reported.
+  double llvmOptimization = 0.0;
+  double codegen = 0.0;
+
+  double getTotal() const {
+    return mlirLowering + llvmTranslation + llvmOptimization + codegen;
+  }
+  // Print the timings as a single line JSON object.
+  void printJSON(llvm::raw_ostream &os) const;
 };
 
 class ModelRunner {
  public:
   enum class Target { CPUTarget, GPUTarget };
   // Initialize the runner with an OwningModuleRef, typically constructed with
-  // a ModelBiulder.
+  // a ModelBiulder. The module is compiled into `sharedJit` if given, and into
+  // a JIT of its own created by `compile` otherwise.
   ModelRunner(mlir::OwningOpRef<mlir::ModuleOp> &m,
-              Target t = Target::CPUTarget)
-      : module(m), target(t) {}
+              Target t = Target::CPUTarget,
+              std::shared_ptr<SharedJIT> sharedJit = nullptr)
+      : module(m), target(t), sharedJit(std::move(sharedJit)) {}
+  ~ModelRunner();
+
+  // Get the JIT the module is compiled into, to share it with other runners.
+  std::shared_ptr<SharedJIT> getSharedJIT() const { return sharedJit; }
 
   // Get the underlying ModuleOp.
   ModuleOp getOperation() { return *module; }
@@ -89,28 +184,69 @@ class ModelRunner {
       llvm::ArrayRef<const std::string> runtime = None,
       llvm::ArrayRef<std::pair<std::string, void *>> extra_symbols = None);
 
+  // Compile the owned `module` ahead of time into the relocatable object file
+  // `objectPath` for the host. The object contains the `_mlir_ciface_` entry
+  // points and their packed interface functions, see AOTLoader.h.
+  llvm::Error compileToObjectFile(CompilationOptions compilationOptions,
+                                  StringRef objectPath);
+
+  // Compile the owned `module` ahead of time into the shared library
+  // `libraryPath`, linked with the system compiler driver against the optional
+  // array of shared runtime support libraries. The library can be loaded
+  // without LLVM or MLIR at runtime with an AOTModule.
+  llvm::Error compileToSharedLibrary(
+      CompilationOptions compilationOptions, StringRef libraryPath,
+      llvm::ArrayRef<const std::string> runtime = None);
+
+  // Return true if the last `compile` loaded the compiled object from the
+  // persistent object cache instead of running LLVM.
+  bool hasLoadedCachedObject() const { return loadedCachedObject; }
+
+  // Return the compile time breakdown of the last `compile` or
+  // `compileToObjectFile`. It is also appended as JSON to the file given by the
+  // `-compile-timings` flag.
+  const CompileTimings &getCompileTimings() const { return compileTimings; }
+
+  // Accumulate hardware performance counters around every `invoke` and
+  // `invokeIndirect` into `counters`, or stop counting if nullptr. Handles
+  // returned by `lookup` are not instrumented. Not thread-safe; the counters
+  // only count the thread that created them.
+  void setPerfCounters(PerfCounters *counters) { perfCounters = counters; }
+
   // Reference to the compiled module.
   mlir::OwningOpRef<mlir::ModuleOp> &module;
 
+  // Invocations are thread-safe once `compile` returns: the entry points of the
+  // module are resolved by `compile`, and invocations only read them.
+
   // Indirect invocation where the caller sets up the proper indirect pointers
   // and passes a void** `args` parameter.
   llvm::Error invokeIndirect(StringRef funcName, void **args) {
-    const std::string adapterName =
-        std::string("_mlir_ciface_") + funcName.str();
-    return engine->invokePacked(adapterName,
-                                llvm::MutableArrayRef<void *>{*args});
+    auto packedFunction = lookupPacked(funcName);
+    if (!packedFunction) return packedFunction.takeError();
+    if (perfCounters) perfCounters->start();
+    (*packedFunction)(args);
+    if (perfCounters) perfCounters->stop();
+    return llvm::Error::success();
   }
 
+  // Look up `funcName` once and return a handle that invokes it with `args`,
+  // or with new arguments of the same types, without any further symbol lookup
+  // or argument allocation.
+  template <typename... Args>
+  llvm::Expected<KernelHandle<Args...>> lookup(StringRef funcName,
+                                               Args &...args);
+
   // Get the underlying data for a StridedMemRefType wrapped in a unique_ptr.
   // Used with SFINAE.
   template <typename T, typename Fun, int U>
-  void *getData(std::unique_ptr<StridedMemRefType<T, U>, Fun> &arg) {
+  static void *getData(std::unique_ptr<StridedMemRefType<T, U>, Fun> &arg) {
     return arg.get();
   }
   // Get the underlying data for an UnrankedMemRefType wrapped in a unique_ptr.
   // Used with SFINAE.
   template <typename T, typename Fun>
-  void *getData(std::unique_ptr<::UnrankedMemRefType<T>, Fun> &arg) {
+  static void *getData(std::unique_ptr<::UnrankedMemRefType<T>, Fun> &arg) {
     return arg->descriptor;
   }
   // Direct invocation based on MemRefType which automatically packs the data.
@@ -119,27 +255,95 @@ class ModelRunner {
   // clang-format off
   llvm::Error invoke(StringRef funcName, Args &...args) {
     // clang-format on
-    const std::string adapterName =
-        std::string("_mlir_ciface_") + funcName.str();
+    auto packedFunction = lookupPacked(funcName);
+    if (!packedFunction) return packedFunction.takeError();
     void *argsArray[] = {getData(args)...};
     std::array<void *, sizeof...(Args)> argsArray2;
     for (unsigned i = 0; i < sizeof...(Args); ++i)
       argsArray2[i] = &argsArray[i];
-    return engine->invokePacked(adapterName,
-                                llvm::MutableArrayRef<void *>{argsArray2});
+    if (perfCounters) perfCounters->start();
+    (*packedFunction)(argsArray2.data());
+    if (perfCounters) perfCounters->stop();
+    return llvm::Error::success();
   }
 
  protected:
   std::function<void(mlir::PassManager &)> getDefaultMLIRPassBuilder();
   void runLoweringPass(std::function<void(mlir::PassManager &)> passBuilder);
 
+  // Steps shared by the JIT and the ahead-of-time compilation: lower the owned
+  // `module` to the LLVM dialect and translate it to LLVM IR for
+  // `targetMachine` with packed interface functions.
+  void lowerToLLVMDialect(const CompilationOptions &compilationOptions);
+  std::unique_ptr<llvm::Module> translateToLLVMIR(
+      llvm::TargetMachine &targetMachine, llvm::LLVMContext &llvmContext,
+      StringRef moduleIdentifier);
+
+  // Look up the function that takes the arguments of the `_mlir_ciface_`
+  // adapter of `funcName` packed into a void** array. Only reads
+  // `packedFunctions` for the entry points resolved by `compile`.
+  llvm::Expected<void (*)(void **)> lookupPacked(StringRef funcName);
+
   Target target;
-  // An execution engine and an associated target machine. The latter must
-  // outlive the former since it may be used by the transformation layers.
-  std::unique_ptr<mlir::ExecutionEngine> engine;
-  std::unique_ptr<llvm::TargetMachine> targetMachine;
+  // The JIT, possibly shared with other runners, and the JITDylib of `module`.
+  std::shared_ptr<SharedJIT> sharedJit;
+  llvm::orc::JITDylib *dylib = nullptr;
+  // The packed interface functions of the `_mlir_ciface_` entry points, keyed
+  // by function name. Immutable after `compile`.
+  llvm::StringMap<void (*)(void **)> packedFunctions;
+  bool loadedCachedObject = false;
+  CompileTimings compileTimings;
+  PerfCounters *perfCounters = nullptr;
 };
 
+// A function of a compiled ModelRunner module along with preallocated storage
+// for its packed arguments. Invoking the handle is a single indirect call.
+// Invoking with new arguments rewrites the storage in place, so a handle must
+// not be invoked from several threads at a time; copy it instead.
+template <typename... Args>
+class KernelHandle {
+ public:
+  KernelHandle(void (*packedFunction)(void **), Args &...args)
+      : packedFunction(packedFunction), data{ModelRunner::getData(args)...} {
+    packData();
+  }
+  KernelHandle(const KernelHandle &other)
+      : packedFunction(other.packedFunction), data(other.data) {
+    packData();
+  }
+  KernelHandle &operator=(const KernelHandle &other) {
+    packedFunction = other.packedFunction;
+    data = other.data;
+    return *this;
+  }
+
+  // Invoke the function with the arguments last passed to the handle.
+  void operator()() { packedFunction(packedArgs.data()); }
+
+  // Invoke the function with new arguments.
+  void operator()(Args &...args) {
+    data = {ModelRunner::getData(args)...};
+    packedFunction(packedArgs.data());
+  }
+
+ private:
+  void packData() {
+    for (unsigned i = 0; i < sizeof...(Args); ++i) packedArgs[i] = &data[i];
+  }
+
+  void (*packedFunction)(void **);
+  std::array<void *, sizeof...(Args)> data;
+  std::array<void *, sizeof...(Args)> packedArgs;
+};
+
+template <typename... Args>
+llvm::Expected<KernelHandle<Args...>> ModelRunner::lookup(StringRef funcName,
+                                                          Args &...args) {
+  auto packedFunction = lookupPacked(funcName);
+  if (!packedFunction) return packedFunction.takeError();
+  return KernelHandle<Args...>(*packedFunction, args...);
+}
+
 }  // namespace mlir
 
 #endif  // IREE_LLVM_SANDBOX_MODELBUILDER_MODELRUNNER_H_
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ModelBuilder/ObjectCache.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+std::string mlir::PersistentObjectCache::getObjectPath(
+    llvm::StringRef key) const {
+  llvm::SmallString<128> path(cacheDir);
+  llvm::sys::path::append(path, key + ".o");
+  return std::string(path.str());
+}
+
+void mlir::PersistentObjectCache::notifyObjectCompiled(
+    const llvm::Module *m, llvm::MemoryBufferRef obj) {
+  if (std::error_code ec = llvm::sys::fs::create_directories(cacheDir)) {
+    llvm::errs() << "cannot create object cache directory " << cacheDir << ": "
+                 << ec.message() << "\n";
+    return;
+  }
+  std::string path = getObjectPath(m->getModuleIdentifier());
+  if (llvm::Error error = llvm::writeFileAtomically(
+          path + ".tmp%%%%%%%%", path, obj.getBuffer())) {
+    llvm::errs() << "cannot write cached object " << path << ": "
+                 << llvm::toString(std::move(error)) << "\n";
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> mlir::PersistentObjectCache::getObject(
+    const llvm::Module *m) {
+  return getObject(m->getModuleIdentifier());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> mlir::PersistentObjectCache::getObject(
+    llvm::StringRef key) {
+  auto buffer = llvm::MemoryBuffer::getFile(getObjectPath(key),
+                                            /*IsText=*/false,
+                                            /*RequiresNullTerminator=*/false);
+  if (!buffer) return nullptr;
+  return std::move(*buffer);
+}
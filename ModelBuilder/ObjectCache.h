@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// ObjectCache.h
+// -----------------------------------------------------------------------------
+//
+// Persistent object cache for the ModelRunner JIT.
+//
+// Compiled objects are stored in a directory as `<key>.o`, where the key is the
+// identifier of the compiled llvm::Module. The ModelRunner sets the identifier
+// to a hash of everything that determines the generated code, such that a new
+// process can load the object of a previous one instead of running LLVM
+// codegen again.
+
+#ifndef IREE_LLVM_SANDBOX_MODELBUILDER_OBJECTCACHE_H_
+#define IREE_LLVM_SANDBOX_MODELBUILDER_OBJECTCACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace mlir {
+
+class PersistentObjectCache : public llvm::ObjectCache {
+ public:
+  explicit PersistentObjectCache(llvm::StringRef cacheDir)
+      : cacheDir(cacheDir.str()) {}
+
+  // Write the object compiled for module `m` to the cache directory. Objects
+  // are written atomically so that concurrent processes never observe a
+  // partially written file.
+  void notifyObjectCompiled(const llvm::Module *m,
+                            llvm::MemoryBufferRef obj) override;
+
+  // Return the cached object of module `m`, or nullptr on a cache miss.
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *m) override;
+
+  // Return the cached object for `key`, or nullptr on a cache miss.
+  std::unique_ptr<llvm::MemoryBuffer> getObject(llvm::StringRef key);
+
+ private:
+  std::string getObjectPath(llvm::StringRef key) const;
+
+  std::string cacheDir;
+};
+
+}  // namespace mlir
+
+#endif  // IREE_LLVM_SANDBOX_MODELBUILDER_OBJECTCACHE_H_
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ModelBuilder/PerfCounters.h"
+
+#include "llvm/Support/Format.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using mlir::PerfCounters;
+
+#ifdef __linux__
+// Return the perf_event type and config of `event`, or None if there is no
+// encoding of `event` for the host.
+static llvm::Optional<std::pair<uint32_t, uint64_t>> getPerfEventConfig(
+    PerfCounters::Event event) {
+  auto cacheConfig = [](uint64_t cache, uint64_t op, uint64_t result) {
+    return std::make_pair(uint32_t(PERF_TYPE_HW_CACHE),
+                          cache | (op << 8) | (result << 16));
+  };
+  switch (event) {
+    case PerfCounters::Event::Cycles:
+      return std::make_pair(uint32_t(PERF_TYPE_HARDWARE),
+                            uint64_t(PERF_COUNT_HW_CPU_CYCLES));
+    case PerfCounters::Event::Instructions:
+      return std::make_pair(uint32_t(PERF_TYPE_HARDWARE),
+                            uint64_t(PERF_COUNT_HW_INSTRUCTIONS));
+    case PerfCounters::Event::L1DReadMisses:
+      return cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                         PERF_COUNT_HW_CACHE_RESULT_MISS);
+    case PerfCounters::Event::LLCMisses:
+      return std::make_pair(uint32_t(PERF_TYPE_HARDWARE),
+                            uint64_t(PERF_COUNT_HW_CACHE_MISSES));
+    case PerfCounters::Event::FPArithInstructions:
+#if defined(__x86_64__)
+      // FP_ARITH_INST_RETIRED with all scalar and packed umasks set, available
+      // since Broadwell. There is no generic perf event for FP operations.
+      if (__builtin_cpu_is("intel"))
+        return std::make_pair(uint32_t(PERF_TYPE_RAW), uint64_t(0xffc7));
+#endif
+      return llvm::None;
+  }
+  return llvm::None;
+}
+#endif
+
+PerfCounters::PerfCounters() {
+#ifdef __linux__
+  for (Event event :
+       {Event::Cycles, Event::Instructions, Event::L1DReadMisses,
+        Event::LLCMisses, Event::FPArithInstructions}) {
+    auto config = getPerfEventConfig(event);
+    if (!config) continue;
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = config->first;
+    attr.config = config->second;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    int fd = syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                     /*group_fd=*/-1, /*flags=*/0);
+    if (fd >= 0) counters.push_back({event, fd});
+  }
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (const Counter &counter : counters) close(counter.fd);
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+  for (const Counter &counter : counters)
+    ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef __linux__
+  for (const Counter &counter : counters)
+    ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+}
+
+void PerfCounters::reset() {
+#ifdef __linux__
+  for (const Counter &counter : counters)
+    ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+#endif
+}
+
+llvm::Optional<uint64_t> PerfCounters::get(Event event) const {
+#ifdef __linux__
+  for (const Counter &counter : counters) {
+    if (counter.event != event) continue;
+    // Value, time enabled and time running.
+    uint64_t values[3];
+    if (read(counter.fd, values, sizeof(values)) != sizeof(values))
+      return llvm::None;
+    if (values[2] == 0) return uint64_t(0);
+    // Scale the count of a multiplexed counter to the time it was enabled.
+    if (values[2] < values[1])
+      return static_cast<uint64_t>(static_cast<double>(values[0]) *
+                                   values[1] / values[2]);
+    return values[0];
+  }
+#endif
+  return llvm::None;
+}
+
+void PerfCounters::print(llvm::raw_ostream &os, uint64_t numIterations) const {
+  for (Event event :
+       {Event::Cycles, Event::Instructions, Event::L1DReadMisses,
+        Event::LLCMisses, Event::FPArithInstructions}) {
+    os << getName(event) << ": ";
+    if (llvm::Optional<uint64_t> count = get(event))
+      os << llvm::format("%.1f", static_cast<double>(*count) / numIterations)
+         << " per iter\n";
+    else
+      os << "unavailable\n";
+  }
+  llvm::Optional<uint64_t> cycles = get(Event::Cycles);
+  llvm::Optional<uint64_t> instructions = get(Event::Instructions);
+  if (cycles && instructions && *cycles)
+    os << "ipc: "
+       << llvm::format("%.2f", static_cast<double>(*instructions) / *cycles)
+       << "\n";
+}
+
+llvm::StringRef PerfCounters::getName(Event event) {
+  switch (event) {
+    case Event::Cycles:
+      return "cycles";
+    case Event::Instructions:
+      return "instructions";
+    case Event::L1DReadMisses:
+      return "l1d-read-misses";
+    case Event::LLCMisses:
+      return "llc-misses";
+    case Event::FPArithInstructions:
+      return "fp-arith-instructions";
+  }
+  return "";
+}
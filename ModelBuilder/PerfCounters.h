@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// PerfCounters.h
+// -----------------------------------------------------------------------------
+//
+// Hardware performance counters for kernel invocations.
+//
+// A PerfCounters object opens Linux perf_event counters for the calling thread:
+// cycles, instructions, L1 data cache read misses, last level cache misses and,
+// on Intel CPUs, retired floating point arithmetic instructions. Counters the
+// kernel or the CPU does not provide are reported as unavailable. Counts are
+// accumulated between `start` and `stop` until `reset`, and scaled when the
+// kernel multiplexes counters.
+//
+// ```
+// PerfCounters counters;
+// runner.setPerfCounters(&counters);
+// runner.invoke(funcName, ...);
+// counters.print(llvm::outs(), /*numIterations=*/1);
+// ```
+
+#ifndef IREE_LLVM_SANDBOX_MODELBUILDER_PERFCOUNTERS_H_
+#define IREE_LLVM_SANDBOX_MODELBUILDER_PERFCOUNTERS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir {
+
+class PerfCounters {
+ public:
+  enum class Event {
+    Cycles,
+    Instructions,
+    L1DReadMisses,
+    LLCMisses,
+    FPArithInstructions
+  };
+
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  // Enable and disable all counters. Counts accumulate across start/stop pairs.
+  void start();
+  void stop();
+  // Zero all counters.
+  void reset();
+
+  // Return the count of `event`, or None if the counter is unavailable.
+  llvm::Optional<uint64_t> get(Event event) const;
+
+  // Print the counts per iteration and the instructions per cycle.
+  void print(llvm::raw_ostream &os, uint64_t numIterations = 1) const;
+
+  static llvm::StringRef getName(Event event);
+
+ private:
+  struct Counter {
+    Event event;
+    int fd;
+  };
+  llvm::SmallVector<Counter, 5> counters;
+};
+
+}  // namespace mlir
+
+#endif  // IREE_LLVM_SANDBOX_MODELBUILDER_PERFCOUNTERS_H_
@@ -39,7 +39,10 @@ void buildMatMat(ModelBuilder &mb, StringLiteral fn) {
 
   auto f = mb.makeFunction(
       fn, {}, {typeA, typeB, typeC},
-      MLIRFuncOpConfig().setEmitCInterface(true).setPreferAvx512(true));
+      MLIRFuncOpConfig()
+          .setEmitCInterface(true)
+          .setPreferAvx512(true)
+          .setHostTarget());
   OpBuilder b(&f.getBody());
   edsc::ScopedContext scope(b, f.getLoc());
 
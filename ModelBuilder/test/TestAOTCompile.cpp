@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: test-aot-compile -library=%t.so 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include <cstdio>
+
+#include "ModelBuilder/AOTLoader.h"
+#include "ModelBuilder/ModelBuilder.h"
+#include "ModelBuilder/ModelRunner.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace mlir;  // NOLINT
+
+static llvm::cl::opt<std::string> library(
+    "library", llvm::cl::desc("Shared library compiled ahead of time"),
+    llvm::cl::value_desc("filename"), llvm::cl::init("-"));
+
+// Compile a vector add ahead of time into `library`.
+template <unsigned M>
+void compileVectorAdd(StringLiteral funcName) {
+  ModelBuilder modelBuilder;
+
+  auto f32 = modelBuilder.f32;
+  auto vectorType = modelBuilder.getVectorType({M}, f32);
+  auto memRefType = modelBuilder.getMemRefType({1}, vectorType);
+
+  auto f = modelBuilder.makeFunction(
+      funcName, {}, {memRefType, memRefType, memRefType},
+      MLIRFuncOpConfig().setEmitCInterface(true));
+  OpBuilder b(&f.getBody());
+  edsc::ScopedContext scope(b, f.getLoc());
+
+  MemRefIndexedValue A(f.getArgument(0)), B(f.getArgument(1)),
+      C(f.getArgument(2));
+  auto zero = std_constant_index(0);
+  C(zero) = A(zero) + B(zero);
+  std_ret();
+
+  ModelRunner runner(modelBuilder.getModuleRef());
+  if (llvm::Error error =
+          runner.compileToSharedLibrary(CompilationOptions(), library)) {
+    llvm::errs() << error << "\n";
+    llvm_unreachable("Error compiling the shared library.");
+  }
+}
+
+// Load `library` and call `funcName` through the AOTModule only.
+template <unsigned M>
+void runVectorAdd(StringLiteral funcName) {
+  std::string errorMessage;
+  auto aotModule = AOTModule::load(library, &errorMessage);
+  if (!aotModule) {
+    std::fprintf(stderr, "%s\n", errorMessage.c_str());
+    llvm_unreachable("Error loading the shared library.");
+  }
+
+  auto oneInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 1.0f;
+  };
+  auto incInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 1.0f + i;
+  };
+  auto zeroInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 0.0f;
+  };
+  auto A = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, oneInit);
+  auto B = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, incInit);
+  auto C = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, zeroInit);
+  if (!aotModule->invoke(funcName, A, B, C))
+    llvm_unreachable("Error running function.");
+  for (unsigned i = 0; i < M; ++i) std::printf("%g ", C->data[0][i]);
+  std::printf("\n");
+
+  // Functions that are not in the library are reported as such.
+  std::printf("found missing function: %d\n",
+              aotModule->lookupPacked("missing") != nullptr);
+}
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestAOTCompile\n");
+
+  compileVectorAdd<4>("test_aot_vector_add");
+  // CHECK: 2 3 4 5
+  // CHECK: found missing function: 0
+  runVectorAdd<4>("test_aot_vector_add");
+}
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: test-compile-timings-jit 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include "ModelBuilder/ModelBuilder.h"
+#include "ModelBuilder/ModelRunner.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace mlir;  // NOLINT
+
+constexpr unsigned M = 4;
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestCompileTimingsJIT\n");
+
+  ModelBuilder modelBuilder;
+  auto f32 = modelBuilder.f32;
+  auto vectorType = modelBuilder.getVectorType({M}, f32);
+  auto memRefType = modelBuilder.getMemRefType({1}, vectorType);
+  {
+    auto f = modelBuilder.makeFunction(
+        "vector_add", {}, {memRefType, memRefType, memRefType},
+        MLIRFuncOpConfig().setEmitCInterface(true));
+    OpBuilder b(&f.getBody());
+    edsc::ScopedContext scope(b, f.getLoc());
+    MemRefIndexedValue A(f.getArgument(0)), B(f.getArgument(1)),
+        C(f.getArgument(2));
+    auto zero = std_constant_index(0);
+    C(zero) = A(zero) + B(zero);
+    std_ret();
+  }
+
+  ModelRunner runner(modelBuilder.getModuleRef());
+  runner.compile(CompilationOptions());
+
+  // The eager JIT reports every stage, and the per pass timings of the
+  // lowering to the LLVM dialect.
+  const CompileTimings &timings = runner.getCompileTimings();
+  // CHECK: stages: 1
+  llvm::outs() << "stages: "
+               << (timings.mlirLowering > 0.0 &&
+                   timings.llvmTranslation > 0.0 &&
+                   timings.llvmOptimization > 0.0 && timings.codegen > 0.0)
+               << "\n";
+  // CHECK: {"mlir_lowering_s":{{.*}},"mlir_passes":[{"name":"convert-vector-to-scf","seconds":{{.*}}}
+  // CHECK-SAME: "llvm_translation_s":{{.*}},"llvm_optimization_s":{{.*}},"codegen_s":{{.*}},"total_s":{{.*}}}
+  timings.printJSON(llvm::outs());
+  llvm::outs() << "\n";
+}
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: test-kernel-handle-jit 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include <chrono>
+#include <cstdio>
+
+#include "ModelBuilder/ModelBuilder.h"
+#include "ModelBuilder/ModelRunner.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace mlir;  // NOLINT
+
+static llvm::cl::opt<unsigned> numIterations(
+    "num-iterations", llvm::cl::desc("Number of timed invocations"),
+    llvm::cl::init(100000));
+
+constexpr unsigned M = 4;
+constexpr StringLiteral kFuncName = "vector_add";
+
+// Print the nanoseconds per call of `numIterations` calls to `fun`.
+template <typename Fun>
+void timeCalls(StringRef name, Fun fun) {
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < numIterations; ++i) fun();
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::printf("%s: %g ns/call\n", name.str().c_str(), ns / numIterations);
+}
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestKernelHandleJIT\n");
+
+  ModelBuilder modelBuilder;
+  auto f32 = modelBuilder.f32;
+  auto vectorType = modelBuilder.getVectorType({M}, f32);
+  auto memRefType = modelBuilder.getMemRefType({1}, vectorType);
+  {
+    auto f = modelBuilder.makeFunction(
+        kFuncName, {}, {memRefType, memRefType, memRefType},
+        MLIRFuncOpConfig().setEmitCInterface(true));
+    OpBuilder b(&f.getBody());
+    edsc::ScopedContext scope(b, f.getLoc());
+    MemRefIndexedValue A(f.getArgument(0)), B(f.getArgument(1)),
+        C(f.getArgument(2));
+    auto zero = std_constant_index(0);
+    C(zero) = A(zero) + B(zero);
+    std_ret();
+  }
+
+  ModelRunner runner(modelBuilder.getModuleRef());
+  runner.compile(CompilationOptions());
+
+  auto incInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 1.0f + i;
+  };
+  auto zeroInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 0.0f;
+  };
+  auto A = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, incInit);
+  auto B = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, incInit);
+  auto C = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, zeroInit);
+  auto D = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, zeroInit);
+
+  auto kernel = runner.lookup(kFuncName, A, B, C);
+  if (!kernel) llvm_unreachable("Error looking up function.");
+
+  // Invoke with the arguments bound at lookup, then with new ones.
+  // CHECK: 2 4 6 8
+  // CHECK: 4 8 12 16
+  (*kernel)();
+  for (unsigned i = 0; i < M; ++i) std::printf("%g ", C->data[0][i]);
+  std::printf("\n");
+  (*kernel)(C, C, D);
+  for (unsigned i = 0; i < M; ++i) std::printf("%g ", D->data[0][i]);
+  std::printf("\n");
+
+  // CHECK: invoke: {{.*}} ns/call
+  // CHECK: handle: {{.*}} ns/call
+  timeCalls("invoke", [&]() {
+    if (runner.invoke(kFuncName, A, B, C))
+      llvm_unreachable("Error running function.");
+  });
+  timeCalls("handle", [&]() { (*kernel)(); });
+}
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: test-lazy-jit 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include <cstdio>
+#include <thread>
+
+#include "ModelBuilder/ModelBuilder.h"
+#include "ModelBuilder/ModelRunner.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace mlir;  // NOLINT
+
+constexpr unsigned M = 4;
+constexpr unsigned kNumFunctions = 8;
+
+// Build `kNumFunctions` functions `scale_<i>` that compute C = A * i.
+void buildScaleFunctions(ModelBuilder &modelBuilder) {
+  auto f32 = modelBuilder.f32;
+  auto vectorType = modelBuilder.getVectorType({M}, f32);
+  auto memRefType = modelBuilder.getMemRefType({1}, vectorType);
+  for (unsigned i = 0; i < kNumFunctions; ++i) {
+    std::string funcName = "scale_" + std::to_string(i);
+    auto f = modelBuilder.makeFunction(
+        funcName, {}, {memRefType, memRefType},
+        MLIRFuncOpConfig().setEmitCInterface(true));
+    OpBuilder b(&f.getBody());
+    edsc::ScopedContext scope(b, f.getLoc());
+    MemRefIndexedValue A(f.getArgument(0)), C(f.getArgument(1));
+    auto zero = std_constant_index(0);
+    Value scale = ModelBuilder::constant_f32(static_cast<float>(i));
+    Value scaleVector = vector_broadcast(vectorType, scale);
+    C(zero) = A(zero) * scaleVector;
+    std_ret();
+  }
+}
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestLazyJIT\n");
+
+  ModelBuilder modelBuilder;
+  buildScaleFunctions(modelBuilder);
+
+  // Only the functions invoked below are compiled, on two compile threads.
+  ModelRunner runner(modelBuilder.getModuleRef());
+  CompilationOptions compilationOptions;
+  compilationOptions.lazyCompilation = true;
+  compilationOptions.numCompileThreads = 2;
+  runner.compile(compilationOptions);
+
+  auto incInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 1.0f + i;
+  };
+  auto zeroInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 0.0f;
+  };
+  auto A = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, incInit);
+  auto C2 = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, zeroInit);
+  auto C5 = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, zeroInit);
+
+  // Invoke two functions concurrently, triggering their compilation.
+  std::thread t2([&]() {
+    if (runner.invoke("scale_2", A, C2))
+      llvm_unreachable("Error running function.");
+  });
+  std::thread t5([&]() {
+    if (runner.invoke("scale_5", A, C5))
+      llvm_unreachable("Error running function.");
+  });
+  t2.join();
+  t5.join();
+
+  // CHECK: 2 4 6 8
+  // CHECK: 5 10 15 20
+  for (unsigned i = 0; i < M; ++i) std::printf("%g ", C2->data[0][i]);
+  std::printf("\n");
+  for (unsigned i = 0; i < M; ++i) std::printf("%g ", C5->data[0][i]);
+  std::printf("\n");
+}
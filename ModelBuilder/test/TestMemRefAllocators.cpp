@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: test-mem-ref-allocators 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include <cstdio>
+
+#include "ModelBuilder/MemRefUtils.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace mlir;  // NOLINT
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestMemRefAllocators\n");
+
+  auto linearInit = [](unsigned idx, float *ptr) { ptr[idx] = idx; };
+
+  // Huge page buffers are aligned to the huge page size.
+  // CHECK: huge pages: 0 5000
+  {
+    auto A = makeInitializedStridedMemRefDescriptor<float, 2, FreeMemRef>(
+        {1024, 1024}, linearInit, llvm::None, &allocHugePages, FreeMemRef());
+    std::printf("huge pages: %llu %g\n",
+                static_cast<unsigned long long>(
+                    reinterpret_cast<uintptr_t>(A->basePtr) % kHugePageSize),
+                A->data[5000]);
+  }
+
+  // CHECK: numa local: 5000
+  {
+    auto A = makeInitializedStridedMemRefDescriptor<float, 2, FreeMemRef>(
+        {1024, 1024}, linearInit, llvm::None, &allocNumaLocal, FreeMemRef());
+    std::printf("numa local: %g\n", A->data[5000]);
+  }
+
+  // A buffer released to the pool is reused by the next allocation of the same
+  // size class.
+  // CHECK: pool reused buffer: 1
+  // CHECK: pool reused descriptor: 1
+  MemRefPool pool;
+  void *buffer, *descriptor;
+  {
+    auto A =
+        makeInitializedStridedMemRefDescriptor<float, 2, MemRefPool::Deleter>(
+            {64, 64}, linearInit, llvm::None, pool.allocator(),
+            pool.deleter());
+    buffer = A->basePtr;
+    descriptor = A.get();
+  }
+  {
+    auto A =
+        makeInitializedStridedMemRefDescriptor<float, 2, MemRefPool::Deleter>(
+            {96, 64}, linearInit, llvm::None, pool.allocator(),
+            pool.deleter());
+    std::printf("pool reused buffer: %d\n", A->basePtr == buffer);
+    std::printf("pool reused descriptor: %d\n", A.get() == descriptor);
+  }
+
+  // Pooled huge page buffers keep the huge page alignment, also when they are
+  // reused.
+  // CHECK: pooled huge pages: 0 0 1
+  MemRefPool hugePagePool(&allocHugePages);
+  {
+    auto A =
+        makeInitializedStridedMemRefDescriptor<float, 2, MemRefPool::Deleter>(
+            {512, 1024}, linearInit, llvm::None, hugePagePool.allocator(),
+            hugePagePool.deleter());
+    buffer = A->basePtr;
+    std::printf("pooled huge pages: %llu ",
+                static_cast<unsigned long long>(
+                    reinterpret_cast<uintptr_t>(A->basePtr) % kHugePageSize));
+  }
+  {
+    auto A =
+        makeInitializedStridedMemRefDescriptor<float, 2, MemRefPool::Deleter>(
+            {512, 1024}, linearInit, llvm::None, hugePagePool.allocator(),
+            hugePagePool.deleter());
+    std::printf("%llu %d\n",
+                static_cast<unsigned long long>(
+                    reinterpret_cast<uintptr_t>(A->basePtr) % kHugePageSize),
+                A->basePtr == buffer);
+  }
+}
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: rm -rf %t && test-object-cache-jit -runtime-support=$(dirname %s)/runtime-support.so -object-cache-dir=%t 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include "ModelBuilder/ModelBuilder.h"
+#include "ModelBuilder/ModelRunner.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace mlir;  // NOLINT
+
+static llvm::cl::opt<std::string> runtimeSupport(
+    "runtime-support", llvm::cl::desc("Runtime support library filename"),
+    llvm::cl::value_desc("filename"), llvm::cl::init("-"));
+
+static llvm::cl::opt<std::string> objectCacheDir(
+    "object-cache-dir", llvm::cl::desc("Persistent object cache directory"),
+    llvm::cl::value_desc("directory"), llvm::cl::init("-"));
+
+// Build, compile and run a vector add through the persistent object cache.
+// Every call builds a fresh module such that only the cache carries compiled
+// code from one call to the next.
+void testVectorAddWithObjectCache(StringLiteral funcName, float scale) {
+  constexpr unsigned M = 4;
+  ModelBuilder modelBuilder;
+
+  auto f32 = modelBuilder.f32;
+  auto vectorType = modelBuilder.getVectorType({M}, f32);
+  auto memRefType = modelBuilder.getMemRefType({1}, vectorType);
+
+  // 1. Build a simple vector_add.
+  {
+    auto f = modelBuilder.makeFunction(
+        funcName, {}, {memRefType, memRefType, memRefType},
+        MLIRFuncOpConfig().setEmitCInterface(true));
+    OpBuilder b(&f.getBody());
+    edsc::ScopedContext scope(b, f.getLoc());
+
+    MemRefIndexedValue A(f.getArgument(0)), B(f.getArgument(1)),
+        C(f.getArgument(2));
+    auto zero = std_constant_index(0);
+    C(zero) = A(zero) + B(zero);
+    (vector_print(C(zero)));
+
+    std_ret();
+  }
+
+  // 2. Compile the function through the object cache.
+  ModelRunner runner(modelBuilder.getModuleRef());
+  CompilationOptions compilationOptions;
+  compilationOptions.objectCacheDir = objectCacheDir;
+  runner.compile(compilationOptions, runtimeSupport);
+
+  // 3. Allocate data and call the funcOp named `funcName`.
+  auto oneInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 1.0f;
+  };
+  auto incInit = [&](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = scale * i;
+  };
+  auto zeroInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 0.0f;
+  };
+  auto A = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, oneInit);
+  auto B = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, incInit);
+  auto C = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, zeroInit);
+  auto err = runner.invoke(funcName, A, B, C);
+  if (err) llvm_unreachable("Error running function.");
+  llvm::outs() << "loaded cached object: " << runner.hasLoadedCachedObject()
+               << "\n";
+  llvm::outs().flush();
+}
+
+int main(int argc, char **argv) {
+  // Allow LLVM setup through command line and parse the
+  // test specific option for a runtime support library.
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestObjectCacheJIT\n");
+
+  // The first compilation runs LLVM and populates the cache.
+  // CHECK: ( 1, 2, 3, 4 )
+  // CHECK: loaded cached object: 0
+  testVectorAddWithObjectCache("test_vector_add_cached", /*scale=*/1.0f);
+
+  // The same module loads the cached object.
+  // CHECK: ( 1, 2, 3, 4 )
+  // CHECK: loaded cached object: 1
+  testVectorAddWithObjectCache("test_vector_add_cached", /*scale=*/1.0f);
+
+  // A different module misses the cache.
+  // CHECK: ( 1, 3, 5, 7 )
+  // CHECK: loaded cached object: 0
+  testVectorAddWithObjectCache("test_vector_add_cached_other", /*scale=*/2.0f);
+}
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: test-perf-counters-jit 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include "ModelBuilder/ModelBuilder.h"
+#include "ModelBuilder/ModelRunner.h"
+#include "ModelBuilder/PerfCounters.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace mlir;  // NOLINT
+
+constexpr unsigned M = 4;
+constexpr unsigned kNumIterations = 1000;
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestPerfCountersJIT\n");
+
+  ModelBuilder modelBuilder;
+  auto f32 = modelBuilder.f32;
+  auto vectorType = modelBuilder.getVectorType({M}, f32);
+  auto memRefType = modelBuilder.getMemRefType({1}, vectorType);
+  {
+    auto f = modelBuilder.makeFunction(
+        "vector_add", {}, {memRefType, memRefType, memRefType},
+        MLIRFuncOpConfig().setEmitCInterface(true));
+    OpBuilder b(&f.getBody());
+    edsc::ScopedContext scope(b, f.getLoc());
+    MemRefIndexedValue A(f.getArgument(0)), B(f.getArgument(1)),
+        C(f.getArgument(2));
+    auto zero = std_constant_index(0);
+    C(zero) = A(zero) + B(zero);
+    std_ret();
+  }
+
+  ModelRunner runner(modelBuilder.getModuleRef());
+  runner.compile(CompilationOptions());
+
+  auto init = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 1.0f + i;
+  };
+  auto A = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, init);
+  auto B = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, init);
+  auto C = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, init);
+
+  // Counters accumulate over all the invocations. They are reported as
+  // unavailable where perf_event_open is not permitted.
+  PerfCounters counters;
+  runner.setPerfCounters(&counters);
+  for (unsigned i = 0; i < kNumIterations; ++i)
+    if (runner.invoke("vector_add", A, B, C))
+      llvm_unreachable("Error running function.");
+  runner.setPerfCounters(nullptr);
+
+  // CHECK: cycles: {{.*}}
+  // CHECK: instructions: {{.*}}
+  // CHECK: l1d-read-misses: {{.*}}
+  // CHECK: llc-misses: {{.*}}
+  // CHECK: fp-arith-instructions: {{.*}}
+  counters.print(llvm::outs(), kNumIterations);
+}
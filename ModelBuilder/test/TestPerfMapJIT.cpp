@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: test-perf-map-jit 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include "ModelBuilder/ModelBuilder.h"
+#include "ModelBuilder/ModelRunner.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+
+using namespace mlir;  // NOLINT
+
+constexpr unsigned M = 4;
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestPerfMapJIT\n");
+
+  ModelBuilder modelBuilder;
+  auto f32 = modelBuilder.f32;
+  auto vectorType = modelBuilder.getVectorType({M}, f32);
+  auto memRefType = modelBuilder.getMemRefType({1}, vectorType);
+  {
+    auto f = modelBuilder.makeFunction(
+        "perf_map_add", {}, {memRefType, memRefType, memRefType},
+        MLIRFuncOpConfig().setEmitCInterface(true));
+    OpBuilder b(&f.getBody());
+    edsc::ScopedContext scope(b, f.getLoc());
+    MemRefIndexedValue A(f.getArgument(0)), B(f.getArgument(1)),
+        C(f.getArgument(2));
+    auto zero = std_constant_index(0);
+    C(zero) = A(zero) + B(zero);
+    std_ret();
+  }
+
+  ModelRunner runner(modelBuilder.getModuleRef());
+  CompilationOptions compilationOptions;
+  compilationOptions.enablePerfNotificationListener = true;
+  runner.compile(compilationOptions);
+
+  // The perf map has one "<address> <size> <name>" line per function.
+  // CHECK-DAG: {{[0-9a-f]+}} {{[0-9a-f]+}} perf_map_add
+  // CHECK-DAG: {{[0-9a-f]+}} {{[0-9a-f]+}} _mlir_ciface_perf_map_add
+  std::string path = "/tmp/perf-" +
+                     std::to_string(llvm::sys::Process::getProcessId()) +
+                     ".map";
+  auto perfMap = llvm::MemoryBuffer::getFile(path);
+  if (!perfMap) llvm_unreachable("Missing perf map.");
+  for (llvm::line_iterator line(**perfMap); !line.is_at_end(); ++line)
+    if (line->contains("perf_map_add")) llvm::outs() << *line << "\n";
+  llvm::sys::fs::remove(path);
+}
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// clang-format off
+
+// NOLINTNEXTLINE
+// RUN: test-shared-jit 2>&1 | IreeFileCheck %s
+
+// clang-format on
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "ModelBuilder/ModelBuilder.h"
+#include "ModelBuilder/ModelRunner.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace mlir;  // NOLINT
+
+constexpr unsigned M = 4;
+constexpr unsigned kNumThreads = 4;
+constexpr unsigned kNumIterations = 1000;
+constexpr StringLiteral kFuncName = "apply";
+
+// Build a function named `kFuncName` that computes C = A + B, or C = A * B if
+// `multiply` is true.
+void buildApply(ModelBuilder &modelBuilder, bool multiply) {
+  auto f32 = modelBuilder.f32;
+  auto vectorType = modelBuilder.getVectorType({M}, f32);
+  auto memRefType = modelBuilder.getMemRefType({1}, vectorType);
+  auto f = modelBuilder.makeFunction(
+      kFuncName, {}, {memRefType, memRefType, memRefType},
+      MLIRFuncOpConfig().setEmitCInterface(true));
+  OpBuilder b(&f.getBody());
+  edsc::ScopedContext scope(b, f.getLoc());
+  MemRefIndexedValue A(f.getArgument(0)), B(f.getArgument(1)),
+      C(f.getArgument(2));
+  auto zero = std_constant_index(0);
+  if (multiply)
+    C(zero) = A(zero) * B(zero);
+  else
+    C(zero) = A(zero) + B(zero);
+  std_ret();
+}
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  llvm::cl::ParseCommandLineOptions(argc, argv, "TestSharedJIT\n");
+
+  // Two models with functions of the same name, compiled into one JIT.
+  ModelBuilder addBuilder, mulBuilder;
+  buildApply(addBuilder, /*multiply=*/false);
+  buildApply(mulBuilder, /*multiply=*/true);
+  ModelRunner addRunner(addBuilder.getModuleRef());
+  addRunner.compile(CompilationOptions());
+  ModelRunner mulRunner(mulBuilder.getModuleRef(),
+                        ModelRunner::Target::CPUTarget,
+                        addRunner.getSharedJIT());
+  mulRunner.compile(CompilationOptions());
+
+  // CHECK: shared: 1
+  std::printf("shared: %d\n",
+              addRunner.getSharedJIT() == mulRunner.getSharedJIT());
+
+  auto incInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 1.0f + i;
+  };
+  auto zeroInit = [](unsigned idx, Vector1D<M, float> *ptr) {
+    for (unsigned i = 0; i < M; ++i) ptr[idx][i] = 0.0f;
+  };
+  auto A = makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+      {1}, incInit);
+  using MemRef = decltype(A);
+  std::vector<MemRef> results;
+  for (unsigned t = 0; t < kNumThreads; ++t)
+    results.push_back(
+        makeInitializedStridedMemRefDescriptor<Vector1D<M, float>, 1>(
+            {1}, zeroInit));
+
+  // Invoke both models concurrently, each thread writing its own result.
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < kNumThreads; ++t) {
+    ModelRunner &runner = t % 2 ? mulRunner : addRunner;
+    threads.emplace_back([&runner, &A, &result = results[t]]() {
+      for (unsigned i = 0; i < kNumIterations; ++i)
+        if (runner.invoke(kFuncName, A, A, result))
+          llvm_unreachable("Error running function.");
+    });
+  }
+  for (std::thread &thread : threads) thread.join();
+
+  // CHECK: 2 4 6 8
+  // CHECK: 1 4 9 16
+  // CHECK: 2 4 6 8
+  // CHECK: 1 4 9 16
+  for (MemRef &result : results) {
+    for (unsigned i = 0; i < M; ++i) std::printf("%g ", result->data[0][i]);
+    std::printf("\n");
+  }
+}
@@ -0,0 +1,24 @@
+//===-- BufferizableOpInterfaceImpl.h - LinalgExt bufferization -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+#ifndef RUNNERS_LINALGEXT_BUFFERIZABLEOPINTERFACEIMPL_H_
+#define RUNNERS_LINALGEXT_BUFFERIZABLEOPINTERFACEIMPL_H_
+
+namespace mlir {
+class DialectRegistry;
+
+namespace linalg_ext {
+
+/// Registers the BufferizableOpInterface external models of the LinalgExt ops
+/// used by comprehensive bufferization. Every op bufferizes in place into its
+/// output buffers, which alias the corresponding results.
+void registerBufferizableOpInterfaceExternalModels(DialectRegistry &registry);
+
+}  // namespace linalg_ext
+}  // namespace mlir
+
+#endif  // RUNNERS_LINALGEXT_BUFFERIZABLEOPINTERFACEIMPL_H_
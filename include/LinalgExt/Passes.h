@@ -17,6 +17,9 @@ namespace linalg_ext {
 std::unique_ptr<OperationPass<FuncOp>> createLinalgExtTilingPass(
     ArrayRef<int64_t> tileSizes = {});
 
+/// Creates a pass to vectorize LinalgExt operations.
+std::unique_ptr<OperationPass<FuncOp>> createLinalgExtVectorizationPass();
+
 #define GEN_PASS_REGISTRATION
 #include "include/LinalgExt/Passes.h.inc"
 
@@ -8,6 +8,7 @@
 
 #include "Transforms.h"
 #include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
 
 namespace mlir {
 namespace linalg {
@@ -17,8 +18,8 @@ using mlir::tensor::ExtractSliceOp;
 using mlir::tensor::InsertSliceOp;
 
 // Tiles a GenericOp that models a reduction and then fuses its inputs and
-// outputs. Currently, only the FillOp that initializes the output is fused into
-// the loop nest.
+// outputs. Currently, only the FillOps that initialize the outputs are fused
+// into the loop nest.
 struct FuseFillOutputIntoGenericOpPattern
     : public OpInterfaceRewritePattern<LinalgOp> {
   FuseFillOutputIntoGenericOpPattern(LinalgTilingOptions options,
@@ -32,14 +33,28 @@ struct FuseFillOutputIntoGenericOpPattern
   LogicalResult matchAndRewrite(LinalgOp linalgOp,
                                 PatternRewriter &rewriter) const override {
     if (failed(filter.checkAndNotify(rewriter, linalgOp))) return failure();
+    // The fused FillOps initialize the iteration arguments of an scf.for nest.
+    if (options.loopType != LinalgTilingLoopType::Loops) return failure();
+
+    // Match the FillOp producers and the combiners of all outputs on the
+    // untiled op, such that a mismatch leaves the IR untouched.
+    SmallVector<FillOp> fillOps;
+    SmallVector<Attribute> neutralAttrs;
+    if (failed(matchFillOutputs(rewriter, linalgOp, fillOps, neutralAttrs)))
+      return failure();
 
     auto tiledOp = tileLinalgOp(rewriter, linalgOp, options);
     if (failed(tiledOp)) return failure();
+    if (tiledOp->loops.empty()) {
+      if (tiledOp->op != linalgOp) rewriter.eraseOp(tiledOp->op);
+      return failure();
+    }
 
-    auto outerLoop = dyn_cast<scf::ForOp>(tiledOp->loops.front());
-    if (!outerLoop) return failure();
-
-    if (failed(FuseFillOp(rewriter, outerLoop, tiledOp->op))) {
+    auto outerLoop = cast<scf::ForOp>(tiledOp->loops.front());
+    if (failed(FuseFillOp(rewriter, outerLoop, tiledOp->op, fillOps,
+                          neutralAttrs))) {
+      // Drop the loop nest, the original op is still in place.
+      rewriter.eraseOp(outerLoop);
       return failure();
     }
     rewriter.replaceOp(linalgOp, outerLoop->getResults());
@@ -58,73 +73,142 @@ struct FuseFillOutputIntoGenericOpPattern
   // with
   //
   // %0 = linalg.fill(%cst, %out)
-  // %1 = linalg.fill(%cst, %0)
+  // %1 = linalg.fill(%neutral, %0)
   //
   // The idea is to still initialize the output of the reduction even if the
   // FillOp is fused into the loop nest. In that case %1 will be fused into
-  // the loop body and %0 will remain outside of the loop.
+  // the loop body and %0 will remain outside of the loop. The fused FillOp
+  // initializes the partial result of a tile and thus has to use the neutral
+  // element of the reduction instead of the initial value %cst.
   std::pair<FillOp, FillOp> ChainFillOp(PatternRewriter &rewriter,
-                                        FillOp fillOp) const {
+                                        FillOp fillOp, Value neutral) const {
     OpBuilder::InsertionGuard g(rewriter);
     rewriter.setInsertionPoint(fillOp);
 
     auto *first = rewriter.clone(*fillOp);
-    auto second = rewriter.replaceOpWithNewOp<FillOp>(fillOp, fillOp.value(),
+    auto second = rewriter.replaceOpWithNewOp<FillOp>(fillOp, neutral,
                                                       first->getResult(0));
     return std::make_pair(cast<FillOp>(first), second);
   }
 
-  // Fuses FillOp producer of the output argument of the loop nest and inserts
-  // an operation that accumulates the partial result, i.e. reduced tile, and
-  // the current value of the output tile.
+  // Matches a distinct FillOp producer for every output of `linalgOp`, and the
+  // neutral element of the combiner that reduces into that output. The partial
+  // results are combined with the output using that combiner, which also
+  // determines the initial value of a tile.
+  LogicalResult matchFillOutputs(
+      PatternRewriter &rewriter, LinalgOp linalgOp,
+      SmallVectorImpl<FillOp> &fillOps,
+      SmallVectorImpl<Attribute> &neutralAttrs) const {
+    int64_t numOutputs = linalgOp.getNumOutputs();
+    if (numOutputs == 0 || !linalgOp.hasTensorSemantics()) return failure();
+    for (int64_t i = 0; i < numOutputs; ++i) {
+      auto fillOp = linalgOp.getOutputOperand(i)->get().getDefiningOp<FillOp>();
+      if (!fillOp || llvm::is_contained(fillOps, fillOp)) return failure();
+
+      Operation *combiner = getCombinerOfLinalgOutput(linalgOp, i);
+      if (!combiner) return failure();
+      Type elementType = getElementTypeOrSelf(fillOp.value().getType());
+      Optional<Attribute> neutralAttr =
+          getNeutralOfCombiner(rewriter, combiner, elementType);
+      if (!neutralAttr.hasValue()) return failure();
+
+      fillOps.push_back(fillOp);
+      neutralAttrs.push_back(*neutralAttr);
+    }
+    return success();
+  }
+
+  // Fuses the FillOp producers of all output arguments of the loop nest. Each
+  // output of a multi-output reduction, e.g. the sum and the sum of squares of
+  // a mean/variance computation, gets its own fused FillOp and accumulation
+  // step. All outputs are checked before any of them is rewritten, such that
+  // a failure leaves the loop nest untouched.
   LogicalResult FuseFillOp(PatternRewriter &rewriter, scf::ForOp outerLoop,
-                           LinalgOp tiledOp) const {
-    if (tiledOp.getNumOutputs() != 1) return failure();
+                           LinalgOp tiledOp, ArrayRef<FillOp> fillOps,
+                           ArrayRef<Attribute> neutralAttrs) const {
+    int64_t numOutputs = tiledOp.getNumOutputs();
+    if (outerLoop.getNumIterOperands() != numOutputs) return failure();
+
+    SmallVector<Operation *> combiners;
+    for (int64_t i = 0; i < numOutputs; ++i) {
+      // The tiled op clones the region of the matched op, so its combiners
+      // are the clones of the matched ones.
+      combiners.push_back(getCombinerOfLinalgOutput(tiledOp, i));
+
+      // Find insert_slice that inserts the result back to the output.
+      Value partialResult = tiledOp->getResult(i);
+      if (partialResult.use_empty() ||
+          !isa<InsertSliceOp>(*partialResult.getUsers().begin()))
+        return failure();
+
+      // The producer can only be fused into the loop nest if the tiled op
+      // reads a slice of the output, i.e. if the output is tiled.
+      if (!tiledOp.getOutputOperand(i)->get().getDefiningOp<ExtractSliceOp>())
+        return failure();
+    }
 
-    OpBuilder::InsertionGuard guard(rewriter);
-    rewriter.setInsertionPointAfter(tiledOp);
+    for (int64_t i = 0; i < numOutputs; ++i)
+      FuseFillOpIntoOutput(rewriter, tiledOp, i, fillOps[i], combiners[i],
+                           neutralAttrs[i]);
+    return success();
+  }
 
-    if (outerLoop.getNumIterOperands() == 0) return failure();
-    auto fillOp = outerLoop.getIterOperands().front().getDefiningOp<FillOp>();
-    if (!fillOp) return failure();
+  // Fuses the FillOp producer of the `outputPos`-th output argument of the
+  // loop nest and inserts an operation that accumulates the partial result,
+  // i.e. reduced tile, and the current value of the output tile.
+  void FuseFillOpIntoOutput(PatternRewriter &rewriter, LinalgOp tiledOp,
+                            int64_t outputPos, FillOp fillOp,
+                            Operation *combiner, Attribute neutralAttr) const {
+    Value neutral;
+    {
+      OpBuilder::InsertionGuard g(rewriter);
+      rewriter.setInsertionPoint(fillOp);
+      neutral = rewriter.create<ConstantOp>(
+          fillOp.getLoc(), neutralAttr.getType(), neutralAttr);
+    }
 
-    auto fillOpChain = ChainFillOp(rewriter, fillOp);
+    auto fillOpChain = ChainFillOp(rewriter, fillOp, neutral);
 
-    Optional<linalg::FusionInfo> fusionInfo =
-        linalg::fuseProducerOfTensor(rewriter, fillOpChain.second->getResult(0),
-                                     *tiledOp.getOutputOperands().front());
-    if (!fusionInfo.hasValue()) return failure();
+    Optional<linalg::FusionInfo> fusionInfo = linalg::fuseProducerOfTensor(
+        rewriter, fillOpChain.second->getResult(0),
+        *tiledOp.getOutputOperand(outputPos));
+    assert(fusionInfo.hasValue() && "expected the output to be fusable");
 
     rewriter.replaceOp(fillOpChain.second, fillOpChain.first.getResult(0));
 
     auto fusedFillOp = cast<FillOp>(fusionInfo->fusedProducer);
 
-    Value partialResult = tiledOp->getResult(0);
-
-    // Find insert_slice that inserts the result back to the output.
-    auto insert = dyn_cast<InsertSliceOp>(*partialResult.getUsers().begin());
-    if (!insert) return failure();
+    Value partialResult = tiledOp->getResult(outputPos);
+    auto insert = cast<InsertSliceOp>(*partialResult.getUsers().begin());
 
     // Create operation that accumulates the partial result into the output.
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointAfter(tiledOp);
     auto numParallelLoops = tiledOp.getNumParallelLoops();
     SmallVector<StringRef, 3> parallelIterTypes(numParallelLoops,
                                                 getParallelIteratorTypeName());
     auto idMap = rewriter.getMultiDimIdentityMap(numParallelLoops);
 
+    // Only the combiner is applied to accumulate the partial result, any
+    // computation of the reduction body that precedes it (e.g. squaring the
+    // input) already happened when computing the partial result.
+    Value outputArg = tiledOp.getRegionOutputArgs()[outputPos];
     auto loc = tiledOp.getLoc();
     auto accumulator = rewriter.create<GenericOp>(
         loc, partialResult.getType(), llvm::makeArrayRef(partialResult),
         llvm::makeArrayRef(fusedFillOp.output()),
-        llvm::makeArrayRef({idMap, idMap}), parallelIterTypes);
+        llvm::makeArrayRef({idMap, idMap}), parallelIterTypes,
+        [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+          BlockAndValueMapping bvm;
+          for (Value operand : combiner->getOperands())
+            bvm.map(operand, operand == outputArg ? args[1] : args[0]);
+          Operation *accumulate = b.clone(*combiner, bvm);
+          b.create<YieldOp>(nestedLoc, accumulate->getResults());
+        });
 
-    auto reduceTile = cast<GenericOp>(tiledOp);
-    BlockAndValueMapping bvm;
-    rewriter.cloneRegionBefore(reduceTile.region(), accumulator.region(),
-                               accumulator.region().end(), bvm);
     rewriter.updateRootInPlace(insert, [&]() {
       insert.sourceMutable().assign(accumulator.getResult(0));
     });
-    return success();
   }
 
   LinalgTransformationFilter filter;
@@ -167,14 +251,14 @@ struct FillOfExtractSlice : public OpRewritePattern<FillOp> {
   }
 };
 
-// Match 2D row reduction. This is a starting point, we will relax this
-// condition further down the road, when we add support for more reduction
-// types.
+// Match 2D row reduction with one or more outputs. This is a starting point,
+// we will relax this condition further down the road, when we add support for
+// more reduction types.
 bool is2DRowReduction(Operation *op) {
   auto reduction = dyn_cast<GenericOp>(op);
   if (!reduction) return false;
 
-  if (reduction.getNumOutputs() != 1 || reduction.getNumLoops() != 2)
+  if (reduction.getNumOutputs() < 1 || reduction.getNumLoops() != 2)
     return false;
   return reduction.getNumReductionLoops() == 1;
 }
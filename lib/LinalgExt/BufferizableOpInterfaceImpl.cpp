@@ -0,0 +1,141 @@
+//===- BufferizableOpInterfaceImpl.cpp - LinalgExt bufferization ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+#include "include/LinalgExt/BufferizableOpInterfaceImpl.h"
+
+#include "include/LinalgExt/LinalgExtOps.h"
+#include "mlir/Dialect/Linalg/ComprehensiveBufferize/BufferizableOpInterface.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Dialect.h"
+#include "mlir/IR/Operation.h"
+
+using namespace mlir;
+using namespace mlir::linalg::comprehensive_bufferize;
+using namespace mlir::linalg_ext;
+
+namespace {
+
+/// Return true if `op` reads the initial value of its output `opOperand`. Most
+/// LinalgExt ops update their outputs in place.
+template <typename OpTy>
+bool readsOutput(OpTy op, OpOperand &opOperand) {
+  return true;
+}
+bool readsOutput(ReverseOp op, OpOperand &opOperand) { return false; }
+bool readsOutput(GatherOp op, OpOperand &opOperand) { return false; }
+bool readsOutput(ScanOp op, OpOperand &opOperand) {
+  // Only the accumulator seeds the scan, the output is overwritten.
+  return &opOperand == op.getOutputOperand(1);
+}
+
+/// Allocate or reuse the buffers of the results of `op` depending on the
+/// inplace decisions of the analysis.
+LogicalResult allocateBuffersForResults(OpBuilder &b, Location loc,
+                                        LinalgExtOp op,
+                                        SmallVectorImpl<Value> &resultBuffers,
+                                        BufferizationState &state) {
+  OpBuilder::InsertionGuard guard(b);
+  b.setInsertionPoint(op);
+  for (OpResult opResult : op->getOpResults()) {
+    assert(opResult.getType().isa<RankedTensorType>() &&
+           "expected ranked tensor results");
+    Value resultBuffer = getResultBuffer(b, opResult, state);
+    if (!resultBuffer) return failure();
+    resultBuffers.push_back(resultBuffer);
+  }
+  if (op->getNumResults()) state.mapBuffer(op->getResults(), resultBuffers);
+  return success();
+}
+
+/// Bufferize `op` by cloning it on the buffers of its operands. The regions of
+/// LinalgExt ops only contain scalar computations and are cloned unchanged.
+LogicalResult bufferizeLinalgExtOp(OpBuilder &b, LinalgExtOp op,
+                                   BufferizationState &state) {
+  // Take a guard before anything else.
+  OpBuilder::InsertionGuard g(b);
+  b.setInsertionPoint(op);
+
+  // Ensure op has only tensors.
+  if (!op.hasTensorSemantics())
+    return op->emitError() << "op does not have tensor semantics";
+
+  Location loc = op.getLoc();
+  SmallVector<Value> newOperands;
+  for (OpOperand *opOperand : op.getInputOperands()) {
+    if (op.isScalar(opOperand)) {
+      newOperands.push_back(opOperand->get());
+      continue;
+    }
+    newOperands.push_back(state.lookupBuffer(opOperand->get()));
+  }
+  SmallVector<Value> newOutputBuffers;
+  if (failed(allocateBuffersForResults(b, loc, op, newOutputBuffers, state)))
+    return failure();
+  newOperands.append(newOutputBuffers.begin(), newOutputBuffers.end());
+
+  // Set insertion point now that potential alloc/dealloc are introduced.
+  b.setInsertionPoint(op);
+  op.clone(b, loc, /*resultTypes=*/TypeRange{}, newOperands);
+
+  // The original op will be DCE'd away later.
+  return success();
+}
+
+template <typename OpTy>
+struct LinalgExtOpInterface
+    : public BufferizableOpInterface::ExternalModel<LinalgExtOpInterface<OpTy>,
+                                                    OpTy> {
+  bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand) const {
+    auto linalgExtOp = cast<LinalgExtOp>(op);
+    if (linalgExtOp.isScalar(&opOperand)) return false;
+    if (opOperand.getOperandNumber() < linalgExtOp.getNumInputs()) return true;
+    return readsOutput(cast<OpTy>(op), opOperand);
+  }
+
+  bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand) const {
+    auto linalgExtOp = cast<LinalgExtOp>(op);
+    return opOperand.getOperandNumber() >= linalgExtOp.getNumInputs();
+  }
+
+  SmallVector<OpOperand *> getAliasingOpOperand(Operation *op,
+                                                OpResult opResult) const {
+    auto linalgExtOp = cast<LinalgExtOp>(op);
+    return {linalgExtOp.getOutputOperand(opResult.getResultNumber())};
+  }
+
+  OpResult getAliasingOpResult(Operation *op, OpOperand &opOperand) const {
+    auto linalgExtOp = cast<LinalgExtOp>(op);
+    if (!opOperand.get().getType().isa<RankedTensorType>()) return OpResult();
+    // Inputs are never inplaceable, every output maps to the result of the
+    // same position.
+    unsigned numInputs = linalgExtOp.getNumInputs();
+    if (opOperand.getOperandNumber() < numInputs) return OpResult();
+    return op->getResult(opOperand.getOperandNumber() - numInputs);
+  }
+
+  BufferRelation bufferRelation(Operation *op, OpOperand &opOperand) const {
+    return BufferRelation::Equivalent;
+  }
+
+  LogicalResult bufferize(Operation *op, OpBuilder &b,
+                          BufferizationState &state) const {
+    return bufferizeLinalgExtOp(b, cast<LinalgExtOp>(op), state);
+  }
+};
+
+}  // namespace
+
+void mlir::linalg_ext::registerBufferizableOpInterfaceExternalModels(
+    DialectRegistry &registry) {
+  registry.addOpInterface<FftOp, LinalgExtOpInterface<FftOp>>();
+  registry.addOpInterface<GatherOp, LinalgExtOpInterface<GatherOp>>();
+  registry.addOpInterface<ReverseOp, LinalgExtOpInterface<ReverseOp>>();
+  registry.addOpInterface<ScanOp, LinalgExtOpInterface<ScanOp>>();
+  registry.addOpInterface<ScatterOp, LinalgExtOpInterface<ScatterOp>>();
+  registry.addOpInterface<SortOp, LinalgExtOpInterface<SortOp>>();
+  registry.addOpInterface<TopkOp, LinalgExtOpInterface<TopkOp>>();
+}
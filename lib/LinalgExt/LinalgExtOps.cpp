@@ -19,9 +19,6 @@
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/OpImplementation.h"
 
-#define GET_OP_CLASSES
-#include "include/LinalgExt/LinalgExtOps.cpp.inc"
-
 using namespace mlir;
 using namespace mlir::linalg_ext;
 
@@ -138,11 +135,11 @@ Operation *ReverseOp::getTiledImplementation(OpBuilder &builder,
   SmallVector<Type, 4> resultTypes;
   if (hasTensorSemantics()) {
     tiledOperands.emplace_back(
-        getSlice(builder, loc, output(), mirrorOffsets, sizes, strides));
+        getSlice(builder, loc, outputs[0], mirrorOffsets, sizes, strides));
     resultTypes.push_back(tiledOperands[1].getType());
   } else {
     tiledOperands.emplace_back(
-        getSlice(builder, loc, output(), mirrorOffsets, sizes, strides));
+        getSlice(builder, loc, outputs[0], mirrorOffsets, sizes, strides));
   }
 
   Operation *tiledRevOp = cast<LinalgExtOp>(getOperation())
@@ -155,3 +152,691 @@ Operation *ReverseOp::getTiledImplementation(OpBuilder &builder,
   }
   return tiledRevOp;
 }
+
+//===----------------------------------------------------------------------===//
+// SortOp
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verify(SortOp op) {
+  if (op.getNumInputs()) {
+    return op.emitOpError("does not expect to take any inputs");
+  }
+  if (op.getNumOutputs() == 0) {
+    return op.emitOpError("expected at least one `outs` operand");
+  }
+
+  Block &block = op.region().front();
+  size_t numOutputs = op.getNumOutputs();
+  if (block.getNumArguments() != 2 * numOutputs) {
+    return op.emitOpError("region block should have ")
+           << 2 * numOutputs << " arguments";
+  }
+
+  int64_t rank = op.getOperandRank();
+  int sortDim = op.dimension();
+  if (sortDim < 0 || sortDim >= rank) {
+    return op.emitOpError("dimension must be within [0, ") << rank << ")";
+  }
+
+  ArrayRef<int64_t> shape = op.getOperandShape();
+  for (auto indexedOperand : llvm::enumerate(op.outputs())) {
+    int index = indexedOperand.index();
+    auto operandType = op.getOperandType(index);
+    if (operandType.getRank() != rank) {
+      return op.emitOpError("expected operand ")
+             << index << " to be rank " << rank << ", same as other operands";
+    }
+    if (operandType.getShape() != shape) {
+      return op.emitOpError("expected operand ")
+             << index << " to have same shape as other operands";
+    }
+    Type elemType = operandType.getElementType();
+    for (int i : {2 * index, 2 * index + 1}) {
+      Type argType = block.getArgument(i).getType();
+      if (argType != elemType) {
+        return op.emitOpError("region block argument #")
+               << i << " should be of type " << elemType << " but got "
+               << argType;
+      }
+    }
+  }
+
+  auto yieldOp = cast<YieldOp>(block.getTerminator());
+  if (yieldOp.getNumOperands() != 1) {
+    return op.emitOpError("should yield exactly one operand");
+  }
+  auto ty = yieldOp.getOperand(0).getType().dyn_cast<IntegerType>();
+  if (!ty || ty.getWidth() != 1) {
+    return op.emitOpError("should yield i1 type");
+  }
+
+  return success();
+}
+
+SmallVector<StringRef> SortOp::getLoopIteratorTypes() {
+  // All loops except the dimension to sort along are parallel.
+  SmallVector<StringRef> iteratorTypes(getOperandRank(),
+                                       getParallelIteratorTypeName());
+  iteratorTypes[getSortDim()] = getReductionIteratorTypeName();
+  return iteratorTypes;
+}
+
+SmallVector<Range> SortOp::getLoopBounds(OpBuilder &builder) {
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Range> ranges;
+  for (auto dim : llvm::seq<int64_t>(0, getOperandRank())) {
+    Value ub = getDimValue(builder, loc, operand(0), dim);
+    ranges.emplace_back(Range{zero, ub, one});
+  }
+  return ranges;
+}
+
+Operation *SortOp::getTiledImplementation(OpBuilder &builder,
+                                          ValueRange outputs,
+                                          ArrayRef<OpFoldResult> offsets,
+                                          ArrayRef<OpFoldResult> sizes) {
+  int64_t rank = getOperandRank();
+  assert(offsets.size() == static_cast<size_t>(rank) &&
+         sizes.size() == static_cast<size_t>(rank));
+  Location loc = getLoc();
+
+  // Every tile sorts full rows: never tile the dimension to sort along.
+  uint64_t sortDim = getSortDim();
+  SmallVector<OpFoldResult> tileOffsets(offsets.begin(), offsets.end());
+  SmallVector<OpFoldResult> tileSizes(sizes.begin(), sizes.end());
+  tileOffsets[sortDim] = builder.getI64IntegerAttr(0);
+  tileSizes[sortDim] = getDim(builder, loc, operand(0), sortDim);
+  SmallVector<OpFoldResult> strides(rank, builder.getI64IntegerAttr(1));
+
+  SmallVector<Value> tiledOperands;
+  SmallVector<Type, 4> resultTypes;
+  for (Value output : outputs) {
+    tiledOperands.emplace_back(
+        getSlice(builder, loc, output, tileOffsets, tileSizes, strides));
+    if (hasTensorSemantics())
+      resultTypes.push_back(tiledOperands.back().getType());
+  }
+
+  return cast<LinalgExtOp>(getOperation())
+      .clone(builder, loc, resultTypes, tiledOperands);
+}
+
+//===----------------------------------------------------------------------===//
+// ScanOp
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verify(ScanOp op) {
+  if (op.getNumInputs() != 1) {
+    return op.emitOpError("expected one `ins` operand");
+  }
+  if (op.getNumOutputs() != 2) {
+    return op.emitOpError("expected two `outs` operands");
+  }
+
+  int64_t rank = op.getOperandRank();
+  int scanDim = op.dimension();
+  if (scanDim < 0 || scanDim >= rank) {
+    return op.emitOpError("dimension must be within [0, ") << rank << ")";
+  }
+
+  ShapedType inputType = op.getOperandType();
+  auto outputType = op.output().getType().cast<ShapedType>();
+  auto accumulatorType = op.accumulator().getType().cast<ShapedType>();
+  if (outputType.getShape() != inputType.getShape()) {
+    return op.emitOpError("expected output to have the shape of the input");
+  }
+  SmallVector<int64_t> expectedAccumulatorShape;
+  for (auto dim : llvm::enumerate(inputType.getShape())) {
+    if (dim.index() != static_cast<size_t>(scanDim))
+      expectedAccumulatorShape.push_back(dim.value());
+  }
+  if (accumulatorType.getShape() !=
+      ArrayRef<int64_t>(expectedAccumulatorShape)) {
+    return op.emitOpError("expected accumulator to have the shape of the "
+                          "input without the scanned dimension");
+  }
+
+  Type elemType = inputType.getElementType();
+  if (outputType.getElementType() != elemType ||
+      accumulatorType.getElementType() != elemType) {
+    return op.emitOpError(
+        "expected input, output and accumulator element types to match");
+  }
+
+  Block &block = op.region().front();
+  if (block.getNumArguments() != 2) {
+    return op.emitOpError("region block should have 2 arguments");
+  }
+  for (BlockArgument arg : block.getArguments()) {
+    if (arg.getType() != elemType) {
+      return op.emitOpError("region block argument #")
+             << arg.getArgNumber() << " should be of type " << elemType
+             << " but got " << arg.getType();
+    }
+  }
+  auto yieldOp = cast<YieldOp>(block.getTerminator());
+  if (yieldOp.getNumOperands() != 1 ||
+      yieldOp.getOperand(0).getType() != elemType) {
+    return op.emitOpError("should yield exactly one operand of type ")
+           << elemType;
+  }
+
+  return success();
+}
+
+SmallVector<StringRef> ScanOp::getLoopIteratorTypes() {
+  // All loops except the dimension to scan along are parallel.
+  SmallVector<StringRef> iteratorTypes(getOperandRank(),
+                                       getParallelIteratorTypeName());
+  iteratorTypes[getScanDim()] = getReductionIteratorTypeName();
+  return iteratorTypes;
+}
+
+SmallVector<Range> ScanOp::getLoopBounds(OpBuilder &builder) {
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Range> ranges;
+  for (auto dim : llvm::seq<int64_t>(0, getOperandRank())) {
+    Value ub = getDimValue(builder, loc, input(), dim);
+    ranges.emplace_back(Range{zero, ub, one});
+  }
+  return ranges;
+}
+
+Operation *ScanOp::getTiledImplementation(OpBuilder &builder,
+                                          ValueRange outputs,
+                                          ArrayRef<OpFoldResult> offsets,
+                                          ArrayRef<OpFoldResult> sizes) {
+  int64_t rank = getOperandRank();
+  assert(offsets.size() == static_cast<size_t>(rank) &&
+         sizes.size() == static_cast<size_t>(rank));
+  Location loc = getLoc();
+
+  // Every tile scans full rows, the scanned dimension is tiled separately by
+  // a two-phase scan. The accumulator is not indexed by the scanned dimension.
+  uint64_t scanDim = getScanDim();
+  SmallVector<OpFoldResult> tileOffsets(offsets.begin(), offsets.end());
+  SmallVector<OpFoldResult> tileSizes(sizes.begin(), sizes.end());
+  tileOffsets[scanDim] = builder.getI64IntegerAttr(0);
+  tileSizes[scanDim] = getDim(builder, loc, input(), scanDim);
+  SmallVector<OpFoldResult> strides(rank, builder.getI64IntegerAttr(1));
+  SmallVector<OpFoldResult> accOffsets(tileOffsets), accSizes(tileSizes),
+      accStrides(strides);
+  accOffsets.erase(accOffsets.begin() + scanDim);
+  accSizes.erase(accSizes.begin() + scanDim);
+  accStrides.erase(accStrides.begin() + scanDim);
+
+  SmallVector<Value> tiledOperands;
+  tiledOperands.emplace_back(
+      getSlice(builder, loc, input(), tileOffsets, tileSizes, strides));
+  tiledOperands.emplace_back(
+      getSlice(builder, loc, outputs[0], tileOffsets, tileSizes, strides));
+  tiledOperands.emplace_back(getSlice(builder, loc, outputs[1], accOffsets,
+                                      accSizes, accStrides));
+
+  SmallVector<Type, 4> resultTypes;
+  if (hasTensorSemantics()) {
+    resultTypes.push_back(tiledOperands[1].getType());
+    resultTypes.push_back(tiledOperands[2].getType());
+  }
+
+  return cast<LinalgExtOp>(getOperation())
+      .clone(builder, loc, resultTypes, tiledOperands);
+}
+
+//===----------------------------------------------------------------------===//
+// ScatterOp and GatherOp
+//===----------------------------------------------------------------------===//
+
+/// Verify the shapes shared by scatter and gather ops: `indices` has shape
+/// `[batch, index_depth]`, the `sliced` operand has shape `[batch, slice...]`
+/// and the `indexed` operand has rank `index_depth + rank(slice)` with trailing
+/// dimensions at least as large as the slice.
+static LogicalResult verifyIndexedSlices(Operation *op, ShapedType indicesType,
+                                         ShapedType slicedType,
+                                         ShapedType indexedType,
+                                         StringRef slicedName,
+                                         StringRef indexedName) {
+  if (indicesType.getRank() != 2 ||
+      indicesType.isDynamicDim(indicesType.getRank() - 1)) {
+    return op->emitOpError(
+        "expected indices to be of rank 2 with a static index depth");
+  }
+  if (!indicesType.getElementType().isIntOrIndex()) {
+    return op->emitOpError("expected indices to be of integer or index type");
+  }
+  if (slicedType.getRank() < 1) {
+    return op->emitOpError("expected ") << slicedName << " to be at least 1-D";
+  }
+  int64_t batch = slicedType.getDimSize(0);
+  int64_t indicesBatch = indicesType.getDimSize(0);
+  if (!ShapedType::isDynamic(batch) && !ShapedType::isDynamic(indicesBatch) &&
+      batch != indicesBatch) {
+    return op->emitOpError("mismatch in batch size of indices and ")
+           << slicedName;
+  }
+
+  int64_t indexDepth = indicesType.getDimSize(1);
+  int64_t sliceRank = slicedType.getRank() - 1;
+  if (indexedType.getRank() != indexDepth + sliceRank) {
+    return op->emitOpError("expected ")
+           << indexedName << " to be of rank " << indexDepth + sliceRank;
+  }
+  for (int64_t dim = 0; dim < sliceRank; ++dim) {
+    int64_t sliceSize = slicedType.getDimSize(dim + 1);
+    int64_t indexedSize = indexedType.getDimSize(dim + indexDepth);
+    if (!ShapedType::isDynamic(sliceSize) &&
+        !ShapedType::isDynamic(indexedSize) && sliceSize > indexedSize) {
+      return op->emitOpError("slice dimension #")
+             << dim << " of " << slicedName << " exceeds the size of "
+             << indexedName;
+    }
+  }
+
+  if (slicedType.getElementType() != indexedType.getElementType()) {
+    return op->emitOpError("expected ")
+           << slicedName << " and " << indexedName
+           << " element types to match";
+  }
+  return success();
+}
+
+/// Return the slice of the `indices` of a scatter or gather for the tile at
+/// `offset` and `size` of the batch dimension.
+static Value getIndicesSlice(OpBuilder &b, Location loc, Value indices,
+                             OpFoldResult offset, OpFoldResult size) {
+  int64_t indexDepth = indices.getType().cast<ShapedType>().getShape().back();
+  SmallVector<OpFoldResult> offsets = {offset, b.getI64IntegerAttr(0)};
+  SmallVector<OpFoldResult> sizes = {size, b.getI64IntegerAttr(indexDepth)};
+  SmallVector<OpFoldResult> strides(2, b.getI64IntegerAttr(1));
+  return getSlice(b, loc, indices, offsets, sizes, strides);
+}
+
+/// Return the slice of the `indexed` operand of a scatter or gather that is
+/// accessed by the tile at `offsets` and `sizes`: the indexed dimensions are
+/// taken whole, the trailing dimensions follow the slice dimensions of the
+/// tile.
+static Value getIndexedSlice(OpBuilder &b, Location loc, Value indexed,
+                             int64_t indexDepth,
+                             ArrayRef<OpFoldResult> offsets,
+                             ArrayRef<OpFoldResult> sizes) {
+  int64_t rank = indexed.getType().cast<ShapedType>().getRank();
+  SmallVector<OpFoldResult> indexedOffsets(indexDepth, b.getI64IntegerAttr(0));
+  SmallVector<OpFoldResult> indexedSizes;
+  for (int64_t dim = 0; dim < indexDepth; ++dim)
+    indexedSizes.push_back(getDim(b, loc, indexed, dim));
+  indexedOffsets.append(offsets.begin() + 1, offsets.end());
+  indexedSizes.append(sizes.begin() + 1, sizes.end());
+  SmallVector<OpFoldResult> strides(rank, b.getI64IntegerAttr(1));
+  return getSlice(b, loc, indexed, indexedOffsets, indexedSizes, strides);
+}
+
+static LogicalResult verify(ScatterOp op) {
+  if (op.getNumInputs() != 2) {
+    return op.emitOpError("expected two `ins` operands");
+  }
+  if (op.getNumOutputs() != 1) {
+    return op.emitOpError("expected one `outs` operand");
+  }
+  if (failed(verifyIndexedSlices(op, op.getIndicesType(), op.getUpdateType(),
+                                 op.getOriginalType(), "updates",
+                                 "original"))) {
+    return failure();
+  }
+
+  Type elemType = op.getOriginalType().getElementType();
+  Block &block = op.region().front();
+  if (block.getNumArguments() != 2) {
+    return op.emitOpError("region block should have 2 arguments");
+  }
+  for (BlockArgument arg : block.getArguments()) {
+    if (arg.getType() != elemType) {
+      return op.emitOpError("region block argument #")
+             << arg.getArgNumber() << " should be of type " << elemType
+             << " but got " << arg.getType();
+    }
+  }
+  auto yieldOp = cast<YieldOp>(block.getTerminator());
+  if (yieldOp.getNumOperands() != 1 ||
+      yieldOp.getOperand(0).getType() != elemType) {
+    return op.emitOpError("should yield exactly one operand of type ")
+           << elemType;
+  }
+  return success();
+}
+
+SmallVector<StringRef> ScatterOp::getLoopIteratorTypes() {
+  // Batch entries may update the same position, they are applied in order.
+  SmallVector<StringRef> iteratorTypes(getUpdateType().getRank(),
+                                       getParallelIteratorTypeName());
+  iteratorTypes[0] = getReductionIteratorTypeName();
+  return iteratorTypes;
+}
+
+SmallVector<Range> ScatterOp::getLoopBounds(OpBuilder &builder) {
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Range> ranges;
+  for (auto dim : llvm::seq<int64_t>(0, getUpdateType().getRank())) {
+    Value ub = getDimValue(builder, loc, updates(), dim);
+    ranges.emplace_back(Range{zero, ub, one});
+  }
+  return ranges;
+}
+
+Operation *ScatterOp::getTiledImplementation(OpBuilder &builder,
+                                             ValueRange outputs,
+                                             ArrayRef<OpFoldResult> offsets,
+                                             ArrayRef<OpFoldResult> sizes) {
+  int64_t rank = getUpdateType().getRank();
+  assert(offsets.size() == static_cast<size_t>(rank) &&
+         sizes.size() == static_cast<size_t>(rank));
+  Location loc = getLoc();
+
+  // The positions updated by a tile are data-dependent: the tiled op updates
+  // all indexed dimensions of `outputs`, which are the destinations of the
+  // enclosing loop nest.
+  SmallVector<OpFoldResult> strides(rank, builder.getI64IntegerAttr(1));
+  SmallVector<Value> tiledOperands;
+  tiledOperands.emplace_back(
+      getSlice(builder, loc, updates(), offsets, sizes, strides));
+  tiledOperands.emplace_back(
+      getIndicesSlice(builder, loc, indices(), offsets[0], sizes[0]));
+  tiledOperands.emplace_back(getIndexedSlice(
+      builder, loc, outputs[0], getIndexDepth(), offsets, sizes));
+
+  SmallVector<Type, 4> resultTypes;
+  if (hasTensorSemantics()) resultTypes.push_back(tiledOperands[2].getType());
+
+  return cast<LinalgExtOp>(getOperation())
+      .clone(builder, loc, resultTypes, tiledOperands);
+}
+
+static LogicalResult verify(GatherOp op) {
+  if (op.getNumInputs() != 2) {
+    return op.emitOpError("expected two `ins` operands");
+  }
+  if (op.getNumOutputs() != 1) {
+    return op.emitOpError("expected one `outs` operand");
+  }
+  return verifyIndexedSlices(op, op.getIndicesType(), op.getOutputType(),
+                             op.getSourceType(), "output", "source");
+}
+
+SmallVector<StringRef> GatherOp::getLoopIteratorTypes() {
+  SmallVector<StringRef> iteratorTypes(getOutputType().getRank(),
+                                       getParallelIteratorTypeName());
+  return iteratorTypes;
+}
+
+SmallVector<Range> GatherOp::getLoopBounds(OpBuilder &builder) {
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Range> ranges;
+  for (auto dim : llvm::seq<int64_t>(0, getOutputType().getRank())) {
+    Value ub = getDimValue(builder, loc, output(), dim);
+    ranges.emplace_back(Range{zero, ub, one});
+  }
+  return ranges;
+}
+
+Operation *GatherOp::getTiledImplementation(OpBuilder &builder,
+                                            ValueRange outputs,
+                                            ArrayRef<OpFoldResult> offsets,
+                                            ArrayRef<OpFoldResult> sizes) {
+  int64_t rank = getOutputType().getRank();
+  assert(offsets.size() == static_cast<size_t>(rank) &&
+         sizes.size() == static_cast<size_t>(rank));
+  Location loc = getLoc();
+
+  SmallVector<OpFoldResult> strides(rank, builder.getI64IntegerAttr(1));
+  SmallVector<Value> tiledOperands;
+  tiledOperands.emplace_back(getIndexedSlice(builder, loc, source(),
+                                             getIndexDepth(), offsets, sizes));
+  tiledOperands.emplace_back(
+      getIndicesSlice(builder, loc, indices(), offsets[0], sizes[0]));
+  tiledOperands.emplace_back(
+      getSlice(builder, loc, outputs[0], offsets, sizes, strides));
+
+  SmallVector<Type, 4> resultTypes;
+  if (hasTensorSemantics()) resultTypes.push_back(tiledOperands[2].getType());
+
+  return cast<LinalgExtOp>(getOperation())
+      .clone(builder, loc, resultTypes, tiledOperands);
+}
+
+//===----------------------------------------------------------------------===//
+// TopkOp
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verify(TopkOp op) {
+  if (op.getNumInputs() != 1 && op.getNumInputs() != 2) {
+    return op.emitOpError("expected one or two `ins` operands");
+  }
+  if (op.getNumOutputs() != 2) {
+    return op.emitOpError("expected two `outs` operands");
+  }
+
+  int64_t rank = op.getInputRank();
+  int dimension = op.dimension();
+  if (dimension < 0 || dimension >= rank) {
+    return op.emitOpError("dimension must be within [0, ") << rank << ")";
+  }
+
+  ShapedType inputType = op.getInputType();
+  auto outputValuesType = op.outputValues().getType().cast<ShapedType>();
+  auto outputIndicesType = op.outputIndices().getType().cast<ShapedType>();
+  if (outputValuesType.getShape() != outputIndicesType.getShape()) {
+    return op.emitOpError("expected output values and indices shapes to match");
+  }
+  if (outputValuesType.getRank() != rank) {
+    return op.emitOpError("expected outputs to be of rank ") << rank;
+  }
+  for (int64_t dim = 0; dim < rank; ++dim) {
+    if (dim == dimension) continue;
+    int64_t inputSize = inputType.getDimSize(dim);
+    int64_t outputSize = outputValuesType.getDimSize(dim);
+    if (!ShapedType::isDynamic(inputSize) &&
+        !ShapedType::isDynamic(outputSize) && inputSize != outputSize) {
+      return op.emitOpError("expected input and output sizes to match in ")
+             << "dimension #" << dim;
+    }
+  }
+  Type elemType = inputType.getElementType();
+  if (outputValuesType.getElementType() != elemType) {
+    return op.emitOpError("expected input and output value types to match");
+  }
+  Type indexType = outputIndicesType.getElementType();
+  if (!indexType.isIntOrIndex()) {
+    return op.emitOpError("expected output indices to be of integer type");
+  }
+  if (Optional<Value> indices = op.indices()) {
+    auto indicesType = indices->getType().cast<ShapedType>();
+    if (indicesType.getShape() != inputType.getShape() ||
+        indicesType.getElementType() != indexType) {
+      return op.emitOpError("expected indices to match the values shape and ")
+             << "the output indices type";
+    }
+  }
+
+  Block &block = op.region().front();
+  if (block.getNumArguments() != 2 && block.getNumArguments() != 4) {
+    return op.emitOpError("region block should have 2 or 4 arguments");
+  }
+  for (BlockArgument arg : block.getArguments()) {
+    Type argType = arg.getArgNumber() < 2 ? elemType : indexType;
+    if (arg.getType() != argType) {
+      return op.emitOpError("region block argument #")
+             << arg.getArgNumber() << " should be of type " << argType
+             << " but got " << arg.getType();
+    }
+  }
+  auto yieldOp = cast<YieldOp>(block.getTerminator());
+  if (yieldOp.getNumOperands() != 1) {
+    return op.emitOpError("should yield exactly one operand");
+  }
+  auto ty = yieldOp.getOperand(0).getType().dyn_cast<IntegerType>();
+  if (!ty || ty.getWidth() != 1) {
+    return op.emitOpError("should yield i1 type");
+  }
+
+  return success();
+}
+
+SmallVector<StringRef> TopkOp::getLoopIteratorTypes() {
+  // All loops except the dimension to select along are parallel.
+  SmallVector<StringRef> iteratorTypes(getInputRank(),
+                                       getParallelIteratorTypeName());
+  iteratorTypes[getDimension()] = getReductionIteratorTypeName();
+  return iteratorTypes;
+}
+
+SmallVector<Range> TopkOp::getLoopBounds(OpBuilder &builder) {
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Range> ranges;
+  for (auto dim : llvm::seq<int64_t>(0, getInputRank())) {
+    Value ub = getDimValue(builder, loc, values(), dim);
+    ranges.emplace_back(Range{zero, ub, one});
+  }
+  return ranges;
+}
+
+Operation *TopkOp::getTiledImplementation(OpBuilder &builder,
+                                          ValueRange outputs,
+                                          ArrayRef<OpFoldResult> offsets,
+                                          ArrayRef<OpFoldResult> sizes) {
+  int64_t rank = getInputRank();
+  assert(offsets.size() == static_cast<size_t>(rank) &&
+         sizes.size() == static_cast<size_t>(rank));
+  Location loc = getLoc();
+
+  // Every tile selects from full rows, the selected dimension is split
+  // separately. Inputs and outputs differ in the size of that dimension.
+  uint64_t dimension = getDimension();
+  SmallVector<OpFoldResult> strides(rank, builder.getI64IntegerAttr(1));
+  auto getRowSlice = [&](Value operand) {
+    SmallVector<OpFoldResult> tileOffsets(offsets.begin(), offsets.end());
+    SmallVector<OpFoldResult> tileSizes(sizes.begin(), sizes.end());
+    tileOffsets[dimension] = builder.getI64IntegerAttr(0);
+    tileSizes[dimension] = getDim(builder, loc, operand, dimension);
+    return getSlice(builder, loc, operand, tileOffsets, tileSizes, strides);
+  };
+
+  SmallVector<Value> tiledOperands;
+  for (Value input : inputs()) tiledOperands.push_back(getRowSlice(input));
+  SmallVector<Type, 4> resultTypes;
+  for (Value output : outputs) {
+    tiledOperands.push_back(getRowSlice(output));
+    if (hasTensorSemantics())
+      resultTypes.push_back(tiledOperands.back().getType());
+  }
+
+  return cast<LinalgExtOp>(getOperation())
+      .clone(builder, loc, resultTypes, tiledOperands);
+}
+
+//===----------------------------------------------------------------------===//
+// FftOp
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verify(FftOp op) {
+  if (op.getNumInputs() != 1 && op.getNumInputs() != 3) {
+    return op.emitOpError(
+        "expected a stage and optionally real and imaginary coefficients as "
+        "`ins` operands");
+  }
+  if (op.getNumOutputs() != 2) {
+    return op.emitOpError("expected two `outs` operands");
+  }
+  if (!op.getStage().getType().isIndex()) {
+    return op.emitOpError("expected the stage to be of index type");
+  }
+
+  ShapedType operandType = op.getOperandType();
+  if (op.getImag().getType() != op.getReal().getType()) {
+    return op.emitOpError("expected real and imaginary parts of same type");
+  }
+  if (operandType.getRank() < 1) {
+    return op.emitOpError("expected real and imaginary parts to be at least ")
+           << "1-D";
+  }
+  Type elemType = operandType.getElementType();
+  if (!elemType.isa<FloatType>()) {
+    return op.emitOpError("expected real and imaginary parts of float type");
+  }
+  int64_t length = op.getFftLength();
+  if (!ShapedType::isDynamic(length) && !llvm::isPowerOf2_64(length)) {
+    return op.emitOpError("only powers of 2 are handled currently");
+  }
+  if (op.hasCoeff()) {
+    for (Value coeff : {op.getRealCoeff(), op.getImagCoeff()}) {
+      auto coeffType = coeff.getType().dyn_cast<ShapedType>();
+      if (!coeffType || coeffType.getRank() != 1 ||
+          coeffType.getElementType() != elemType) {
+        return op.emitOpError("expected coefficients to be 1-D of type ")
+               << elemType;
+      }
+    }
+  }
+  return success();
+}
+
+SmallVector<StringRef> FftOp::getLoopIteratorTypes() {
+  // The butterflies of a stage span up to the whole innermost dimension, which
+  // is processed as a whole. All other dimensions are parallel.
+  SmallVector<StringRef> iteratorTypes(getOperandRank(),
+                                       getParallelIteratorTypeName());
+  iteratorTypes.back() = getReductionIteratorTypeName();
+  return iteratorTypes;
+}
+
+SmallVector<Range> FftOp::getLoopBounds(OpBuilder &builder) {
+  Location loc = getLoc();
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.create<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Range> ranges;
+  for (auto dim : llvm::seq<int64_t>(0, getOperandRank())) {
+    Value ub = getDimValue(builder, loc, getReal(), dim);
+    ranges.emplace_back(Range{zero, ub, one});
+  }
+  return ranges;
+}
+
+Operation *FftOp::getTiledImplementation(OpBuilder &builder,
+                                         ValueRange outputs,
+                                         ArrayRef<OpFoldResult> offsets,
+                                         ArrayRef<OpFoldResult> sizes) {
+  int64_t rank = getOperandRank();
+  assert(offsets.size() == static_cast<size_t>(rank) &&
+         sizes.size() == static_cast<size_t>(rank));
+  Location loc = getLoc();
+
+  // Every tile transforms full rows.
+  SmallVector<OpFoldResult> tileOffsets(offsets.begin(), offsets.end());
+  SmallVector<OpFoldResult> tileSizes(sizes.begin(), sizes.end());
+  tileOffsets.back() = builder.getI64IntegerAttr(0);
+  tileSizes.back() = getDim(builder, loc, getReal(), rank - 1);
+  SmallVector<OpFoldResult> strides(rank, builder.getI64IntegerAttr(1));
+
+  SmallVector<Value> tiledOperands(inputs().begin(), inputs().end());
+  SmallVector<Type, 4> resultTypes;
+  for (Value output : outputs) {
+    tiledOperands.emplace_back(
+        getSlice(builder, loc, output, tileOffsets, tileSizes, strides));
+    if (hasTensorSemantics())
+      resultTypes.push_back(tiledOperands.back().getType());
+  }
+
+  return cast<LinalgExtOp>(getOperation())
+      .clone(builder, loc, resultTypes, tiledOperands);
+}
+
+#define GET_OP_CLASSES
+#include "include/LinalgExt/LinalgExtOps.cpp.inc"
@@ -8,9 +8,17 @@
 #include "include/LinalgExt/LinalgExtOps.h"
 #include "include/LinalgExt/PassDetail.h"
 #include "include/LinalgExt/Passes.h"
+#include "lib/Transforms.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/Identifier.h"
 #include "mlir/IR/Operation.h"
 #include "mlir/IR/PatternMatch.h"
@@ -37,6 +45,443 @@ static Value insertSliceIntoTensor(OpBuilder &b, Location loc,
       sliceOp.static_sizes(), sliceOp.static_strides());
 }
 
+/// Return the map from the loops of `op` to the dimensions of `result`.
+/// Results of the rank of the iteration space are indexed by all loops, results
+/// of lower rank (e.g. the accumulator of a scan) by the parallel loops only.
+static AffineMap getResultTileMap(TilingInterface op, OpResult result) {
+  SmallVector<StringRef> iteratorTypes = op.getLoopIteratorTypes();
+  int64_t numLoops = iteratorTypes.size();
+  MLIRContext *context = op->getContext();
+  if (result.getType().cast<ShapedType>().getRank() == numLoops)
+    return AffineMap::getMultiDimIdentityMap(numLoops, context);
+  SmallVector<AffineExpr> exprs;
+  for (auto it : llvm::enumerate(iteratorTypes))
+    if (it.value() == getParallelIteratorTypeName())
+      exprs.push_back(getAffineDimExpr(it.index(), context));
+  return AffineMap::get(numLoops, /*symbolCount=*/0, exprs, context);
+}
+
+/// Return the entries of `values` indexed by the dimensions of `map`.
+static SmallVector<OpFoldResult> projectTileValues(
+    ArrayRef<OpFoldResult> values, AffineMap map) {
+  SmallVector<OpFoldResult> projected;
+  for (AffineExpr expr : map.getResults())
+    projected.push_back(values[expr.cast<AffineDimExpr>().getPosition()]);
+  return projected;
+}
+
+/// Return the tile size of the loop `dim` of `op` computed by `options`, or
+/// nullptr if the loop is not tiled. Tile sizes that are not returned are
+/// erased again to leave the IR unchanged.
+static Value getLoopTileSize(PatternRewriter &rewriter, Operation *op,
+                             const linalg::LinalgTilingOptions &options,
+                             unsigned dim) {
+  SmallVector<Value> tileSizes =
+      options.tileSizeComputationFunction(rewriter, op);
+  Value tileSize;
+  if (dim < tileSizes.size() && !isZero(tileSizes[dim]))
+    tileSize = tileSizes[dim];
+  for (Value size : tileSizes)
+    if (size != tileSize && size.use_empty())
+      rewriter.eraseOp(size.getDefiningOp());
+  return tileSize;
+}
+
+/// Return the sizes of `shaped`, as attributes for static dimensions.
+static SmallVector<OpFoldResult> getMixedDims(OpBuilder &b, Location loc,
+                                              Value shaped) {
+  auto type = shaped.getType().cast<ShapedType>();
+  SmallVector<OpFoldResult> dims;
+  for (int64_t dim = 0, rank = type.getRank(); dim < rank; ++dim) {
+    if (type.isDynamicDim(dim))
+      dims.push_back(linalg::createOrFoldDimOp(b, loc, shaped, dim));
+    else
+      dims.push_back(b.getIndexAttr(type.getDimSize(dim)));
+  }
+  return dims;
+}
+
+/// Return the number of tiles of size `tileSize` that cover `size`.
+static OpFoldResult getNumTiles(OpBuilder &b, Location loc, OpFoldResult size,
+                                Value tileSize) {
+  auto cstTileSize = tileSize.getDefiningOp<arith::ConstantIndexOp>();
+  if (auto attr = size.dyn_cast<Attribute>()) {
+    if (cstTileSize) {
+      int64_t staticSize = attr.cast<IntegerAttr>().getInt();
+      return b.getIndexAttr(llvm::divideCeil(staticSize, cstTileSize.value()));
+    }
+  }
+  Value one = b.create<arith::ConstantIndexOp>(loc, 1);
+  Value dynamicSize = getValueOrCreateConstantIndexOp(b, loc, size);
+  Value rounded = b.create<arith::SubIOp>(
+      loc, b.create<arith::AddIOp>(loc, dynamicSize, tileSize), one);
+  return b.create<arith::DivUIOp>(loc, rounded, tileSize).getResult();
+}
+
+/// Return the neutral element of the combiner of the scan `op` if the combiner
+/// is a single arithmetic operation on the two region arguments with a known
+/// neutral element.
+static Optional<Attribute> getNeutralOfScanCombiner(OpBuilder &b, ScanOp op) {
+  Block &block = op.region().front();
+  if (!llvm::hasSingleElement(block.without_terminator())) return llvm::None;
+  Operation *combiner = &block.front();
+  if (combiner->getNumResults() != 1 ||
+      block.getTerminator()->getOperand(0) != combiner->getResult(0))
+    return llvm::None;
+  if (combiner->getNumOperands() != 2 ||
+      llvm::any_of(combiner->getOperands(), [&](Value operand) {
+        auto arg = operand.dyn_cast<BlockArgument>();
+        return !arg || arg.getOwner() != &block;
+      }))
+    return llvm::None;
+
+  return linalg::getNeutralOfCombiner(b, combiner,
+                                      combiner->getResult(0).getType());
+}
+
+/// Clone the combiner of the scan `op` to combine `lhs` and `rhs`.
+static Value cloneScanCombiner(OpBuilder &b, ScanOp op, Value lhs, Value rhs) {
+  Block &block = op.region().front();
+  BlockAndValueMapping bvm;
+  bvm.map(block.getArgument(0), lhs);
+  bvm.map(block.getArgument(1), rhs);
+  for (Operation &nested : block.without_terminator()) b.clone(nested, bvm);
+  return bvm.lookupOrDefault(block.getTerminator()->getOperand(0));
+}
+
+/// Return the element that the comparator of the top-k `op` orders after all
+/// other elements if the comparator is a single comparison of the two region
+/// arguments, e.g. -inf for `arith.cmpf ogt`.
+static Optional<Attribute> getLastOfTopkComparator(OpBuilder &b, TopkOp op) {
+  Block &block = op.region().front();
+  if (!llvm::hasSingleElement(block.without_terminator())) return llvm::None;
+  Operation *comparator = &block.front();
+  if (comparator->getNumResults() != 1 ||
+      block.getTerminator()->getOperand(0) != comparator->getResult(0) ||
+      comparator->getNumOperands() != 2)
+    return llvm::None;
+  // A comparator of the swapped arguments orders in the reverse direction.
+  bool swapped;
+  if (comparator->getOperand(0) == block.getArgument(0) &&
+      comparator->getOperand(1) == block.getArgument(1))
+    swapped = false;
+  else if (comparator->getOperand(0) == block.getArgument(1) &&
+           comparator->getOperand(1) == block.getArgument(0))
+    swapped = true;
+  else
+    return llvm::None;
+
+  Type type = block.getArgument(0).getType();
+  if (auto cmpOp = dyn_cast<arith::CmpFOp>(comparator)) {
+    bool greater;
+    switch (cmpOp.getPredicate()) {
+      case arith::CmpFPredicate::OGT:
+      case arith::CmpFPredicate::OGE:
+      case arith::CmpFPredicate::UGT:
+      case arith::CmpFPredicate::UGE:
+        greater = true;
+        break;
+      case arith::CmpFPredicate::OLT:
+      case arith::CmpFPredicate::OLE:
+      case arith::CmpFPredicate::ULT:
+      case arith::CmpFPredicate::ULE:
+        greater = false;
+        break;
+      default:
+        return llvm::None;
+    }
+    const llvm::fltSemantics &semantics =
+        type.cast<FloatType>().getFloatSemantics();
+    return Attribute(b.getFloatAttr(
+        type, APFloat::getInf(semantics, /*Negative=*/greater != swapped)));
+  }
+  if (auto cmpOp = dyn_cast<arith::CmpIOp>(comparator)) {
+    unsigned width = type.getIntOrFloatBitWidth();
+    bool greater;
+    bool isSigned;
+    switch (cmpOp.getPredicate()) {
+      case arith::CmpIPredicate::sgt:
+      case arith::CmpIPredicate::sge:
+        greater = true;
+        isSigned = true;
+        break;
+      case arith::CmpIPredicate::slt:
+      case arith::CmpIPredicate::sle:
+        greater = false;
+        isSigned = true;
+        break;
+      case arith::CmpIPredicate::ugt:
+      case arith::CmpIPredicate::uge:
+        greater = true;
+        isSigned = false;
+        break;
+      case arith::CmpIPredicate::ult:
+      case arith::CmpIPredicate::ule:
+        greater = false;
+        isSigned = false;
+        break;
+      default:
+        return llvm::None;
+    }
+    bool min = greater != swapped;
+    APInt last = isSigned ? (min ? APInt::getSignedMinValue(width)
+                                 : APInt::getSignedMaxValue(width))
+                          : (min ? APInt::getMinValue(width)
+                                 : APInt::getMaxValue(width));
+    return Attribute(b.getIntegerAttr(type, last));
+  }
+  return llvm::None;
+}
+
+/// Extend the comparator region of `tiledOp`, a clone of the top-k `op`, with
+/// the indices of the compared elements. Elements that the comparator orders
+/// equally, e.g. an element equal to the last element and a padding candidate,
+/// are ordered by their index instead: a real element before a candidate with
+/// index `padValue`.
+static void addTopkPaddingTieBreak(OpBuilder &b, TopkOp op, Operation *tiledOp,
+                                   Type indexType, Attribute padValue) {
+  Location loc = op.getLoc();
+  Block &block = tiledOp->getRegion(0).front();
+  Value lhsIndex = block.addArgument(indexType);
+  Value rhsIndex = block.addArgument(indexType);
+  auto yieldOp = cast<YieldOp>(block.getTerminator());
+  Operation *comparator = yieldOp.getOperand(0).getDefiningOp();
+
+  OpBuilder::InsertionGuard guard(b);
+  b.setInsertionPoint(yieldOp);
+  Value before = comparator->getResult(0);
+  Operation *reversed = b.clone(*comparator);
+  reversed->setOperand(0, comparator->getOperand(1));
+  reversed->setOperand(1, comparator->getOperand(0));
+  Value after = reversed->getResult(0);
+  Value pad = b.create<arith::ConstantOp>(loc, padValue);
+  Value sameRank = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                           before, after);
+  Value lhsIsReal =
+      b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ne, lhsIndex, pad);
+  Value rhsIsReal =
+      b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ne, rhsIndex, pad);
+  Value oneIsReal = b.create<arith::XOrIOp>(loc, lhsIsReal, rhsIsReal);
+  Value breakTie = b.create<arith::AndIOp>(loc, sameRank, oneIsReal);
+  yieldOp->setOperand(
+      0, b.create<SelectOp>(loc, breakTie, lhsIsReal, before).getResult());
+}
+
+/// Return the sizes of the tile at `offsets`: the tile sizes clamped to the
+/// remainder of the loop bounds `allDims`, and the full bounds of the loops
+/// that are not tiled. Unlike linalg::computeTileSizes, which returns closed
+/// intervals for linalg::makeTiledShape, these are the sizes of the slices.
+static SmallVector<OpFoldResult> getBoundedTileSizes(
+    OpBuilder &b, Location loc, ArrayRef<Value> offsets,
+    ArrayRef<Value> tileSizes, ArrayRef<Value> allDims) {
+  MLIRContext *context = b.getContext();
+  AffineExpr d0, s0, s1;
+  bindDims(context, d0);
+  bindSymbols(context, s0, s1);
+  AffineMap minMap = AffineMap::get(1, 2, {s0, s1 - d0}, context);
+  SmallVector<OpFoldResult> sizes;
+  for (unsigned idx = 0, e = tileSizes.size(); idx < e; ++idx) {
+    if (isZero(tileSizes[idx])) {
+      sizes.push_back(allDims[idx]);
+      continue;
+    }
+    sizes.push_back(
+        b.create<AffineMinOp>(
+             loc, minMap,
+             ValueRange{offsets[idx], tileSizes[idx], allDims[idx]})
+            .getResult());
+  }
+  return sizes;
+}
+
+/// Create the tiled implementation of `op` for the tile at `ivs` that updates
+/// `destinations` directly and return the updated destinations. On buffers,
+/// the tiled op writes through subviews and no values are returned.
+static SmallVector<Value> tileIntoDestinations(
+    OpBuilder &b, Location loc, TilingInterface op, ValueRange ivs,
+    ValueRange destinations, ArrayRef<Value> tileSizes,
+    ArrayRef<Value> allDims, Operation *&tiledOp) {
+  SmallVector<Value> offsets =
+      linalg::computeTileOffsets(b, loc, ivs, tileSizes);
+  SmallVector<OpFoldResult> mixedOffsets(offsets.begin(), offsets.end());
+  SmallVector<OpFoldResult> mixedSizes =
+      getBoundedTileSizes(b, loc, offsets, tileSizes, allDims);
+  tiledOp =
+      op.getTiledImplementation(b, destinations, mixedOffsets, mixedSizes);
+  // Insert the updated destination tiles into the destinations.
+  auto tiledLinalgExtOp = cast<LinalgExtOp>(tiledOp);
+  SmallVector<Value> results;
+  for (OpResult result : tiledOp->getResults()) {
+    unsigned resultNumber = result.getResultNumber();
+    auto sliceOp = tiledLinalgExtOp.getOutputOperand(resultNumber)
+                       ->get()
+                       .getDefiningOp<tensor::ExtractSliceOp>();
+    assert(sliceOp && "expected ExtractSliceOp");
+    results.push_back(insertSliceIntoTensor(b, loc, sliceOp, result,
+                                            destinations[resultNumber]));
+  }
+  return results;
+}
+
+/// Build a loop nest of type `loopType` over the tiles of the parallel loops
+/// of `op`. Every iteration creates the tiled implementation of `op` on the
+/// outputs of the loop, such that the iterations are independent. Return the
+/// results of the loop nest, which are empty for ops on buffers. scf.parallel
+/// has no tensor results and is only built for ops on buffers.
+static SmallVector<Value> buildParallelTileLoops(
+    OpBuilder &b, Location loc, TilingInterface op,
+    linalg::LinalgTilingLoopType loopType, ValueRange lbs, ValueRange ubs,
+    ValueRange steps, ArrayRef<Value> tileSizes, ArrayRef<Value> allDims,
+    Operation *&tiledOp) {
+  SmallVector<Value> destinations = op.getDestinationOperands(b);
+  bool hasTensorSemantics =
+      cast<LinalgExtOp>(op.getOperation()).hasTensorSemantics();
+  switch (loopType) {
+    case linalg::LinalgTilingLoopType::Loops: {
+      // On buffers the tiled op writes through subviews and the loops carry
+      // no values.
+      if (!hasTensorSemantics) {
+        scf::buildLoopNest(b, loc, lbs, ubs, steps,
+                           [&](OpBuilder &b, Location loc, ValueRange ivs) {
+                             (void)tileIntoDestinations(
+                                 b, loc, op, ivs, destinations, tileSizes,
+                                 allDims, tiledOp);
+                           });
+        return SmallVector<Value>();
+      }
+      auto loopNest = scf::buildLoopNest(
+          b, loc, lbs, ubs, steps, destinations,
+          [&](OpBuilder &b, Location loc, ValueRange ivs,
+              ValueRange iterArgs) -> scf::ValueVector {
+            return tileIntoDestinations(b, loc, op, ivs, iterArgs, tileSizes,
+                                        allDims, tiledOp);
+          });
+      return SmallVector<Value>(loopNest.getResults());
+    }
+    case linalg::LinalgTilingLoopType::ParallelLoops: {
+      assert(!hasTensorSemantics && "expected buffer semantics");
+      b.create<scf::ParallelOp>(
+          loc, lbs, ubs, steps,
+          [&](OpBuilder &b, Location loc, ValueRange ivs) {
+            (void)tileIntoDestinations(b, loc, op, ivs, destinations,
+                                       tileSizes, allDims, tiledOp);
+          });
+      return SmallVector<Value>();
+    }
+    case linalg::LinalgTilingLoopType::TiledLoops: {
+      SmallVector<Attribute> iteratorTypes(
+          lbs.size(), b.getStringAttr(getParallelIteratorTypeName()));
+      auto tiledLoop = b.create<linalg::TiledLoopOp>(
+          loc, lbs, ubs, steps, /*inputs=*/ValueRange{}, destinations,
+          b.getArrayAttr(iteratorTypes),
+          [&](OpBuilder &b, Location loc, ValueRange ivs, ValueRange inputs,
+              ValueRange outputs) {
+            SmallVector<Value> results = tileIntoDestinations(
+                b, loc, op, ivs, outputs, tileSizes, allDims, tiledOp);
+            b.create<linalg::YieldOp>(loc, results);
+          });
+      return SmallVector<Value>(tiledLoop.getResults());
+    }
+  }
+  llvm_unreachable("unexpected loop type");
+}
+
+/// Build a single loop of type `loopType` from `lb` to `ub` with step `step`
+/// that carries the tensors `inits`. `bodyBuilder` returns the values yielded
+/// by every iteration, which have to update disjoint slices of the carried
+/// tensors when the loop is a linalg.tiled_loop. scf.parallel has no tensor
+/// results and is not supported.
+static SmallVector<Value> buildTensorTileLoop(
+    OpBuilder &b, Location loc, linalg::LinalgTilingLoopType loopType,
+    Value lb, Value ub, Value step, ValueRange inits,
+    function_ref<SmallVector<Value>(OpBuilder &, Location, Value, ValueRange)>
+        bodyBuilder) {
+  switch (loopType) {
+    case linalg::LinalgTilingLoopType::Loops: {
+      auto forOp = b.create<scf::ForOp>(
+          loc, lb, ub, step, inits,
+          [&](OpBuilder &b, Location loc, Value iv, ValueRange iterArgs) {
+            b.create<scf::YieldOp>(loc, bodyBuilder(b, loc, iv, iterArgs));
+          });
+      return SmallVector<Value>(forOp.getResults());
+    }
+    case linalg::LinalgTilingLoopType::TiledLoops: {
+      auto tiledLoop = b.create<linalg::TiledLoopOp>(
+          loc, lb, ub, step, /*inputs=*/ValueRange{}, inits,
+          b.getStrArrayAttr({getParallelIteratorTypeName()}),
+          [&](OpBuilder &b, Location loc, ValueRange ivs, ValueRange inputs,
+              ValueRange outputs) {
+            b.create<linalg::YieldOp>(loc,
+                                      bodyBuilder(b, loc, ivs[0], outputs));
+          });
+      return SmallVector<Value>(tiledLoop.getResults());
+    }
+    default:
+      llvm_unreachable("unexpected loop type");
+  }
+}
+
+/// Return true if `sliceOp` extracts the full extent of every dimension of a
+/// result of `op` that is indexed by a non-parallel loop. The tiled
+/// implementation processes these dimensions as a whole, so it only computes
+/// such slices. The slices created by OpTilingPattern always qualify.
+static bool coversNonParallelDims(TilingInterface op,
+                                  tensor::ExtractSliceOp sliceOp) {
+  OpResult result = sliceOp.source().cast<OpResult>();
+  auto resultType = result.getType().cast<ShapedType>();
+  AffineMap map = getResultTileMap(op, result);
+  SmallVector<StringRef> iteratorTypes = op.getLoopIteratorTypes();
+  SmallVector<OpFoldResult> offsets = sliceOp.getMixedOffsets();
+  SmallVector<OpFoldResult> sizes = sliceOp.getMixedSizes();
+  SmallVector<OpFoldResult> strides = sliceOp.getMixedStrides();
+  for (auto it : llvm::enumerate(map.getResults())) {
+    unsigned loop = it.value().cast<AffineDimExpr>().getPosition();
+    if (iteratorTypes[loop] == getParallelIteratorTypeName()) continue;
+    unsigned dim = it.index();
+    if (getConstantIntValue(offsets[dim]) != static_cast<int64_t>(0) ||
+        getConstantIntValue(strides[dim]) != static_cast<int64_t>(1))
+      return false;
+    if (!resultType.isDynamicDim(dim)) {
+      if (getConstantIntValue(sizes[dim]) != resultType.getDimSize(dim))
+        return false;
+      continue;
+    }
+    tensor::DimOp dimOp;
+    if (auto size = sizes[dim].dyn_cast<Value>())
+      dimOp = size.getDefiningOp<tensor::DimOp>();
+    if (!dimOp || dimOp.source() != result ||
+        dimOp.getConstantIndex() != static_cast<int64_t>(dim))
+      return false;
+  }
+  return true;
+}
+
+/// Return true if all uses of the results of `op` are slices nested in a loop
+/// below `op`, e.g. in the tile loop of a consumer, and each of them can be
+/// computed by the tiled implementation of `op`. Such ops are fused into the
+/// loop by swapping them with the slices instead of being tiled on their own.
+static bool isConsumedByTileLoops(TilingInterface op) {
+  if (op->use_empty()) return false;
+  return llvm::all_of(op->getUsers(), [&](Operation *user) {
+    auto sliceOp = dyn_cast<tensor::ExtractSliceOp>(user);
+    return sliceOp && user->getBlock() != op->getBlock() &&
+           op->getParentRegion()->isAncestor(user->getParentRegion()) &&
+           coversNonParallelDims(op, sliceOp);
+  });
+}
+
+/// Return true if `op` is a linalg op that can be fused into the tile loops of
+/// a LinalgExt consumer, i.e. an elementwise op or a fill: all loops are
+/// parallel and the results are indexed by the loops in order. The tile of a
+/// result is then computed from the same tile of the loops.
+static bool isFusableLinalgProducer(linalg::LinalgOp op) {
+  if (!op.hasTensorSemantics() || op.hasIndexSemantics()) return false;
+  if (op.getNumLoops() != op.getNumParallelLoops()) return false;
+  return llvm::all_of(op.getOutputOperands(), [&](OpOperand *opOperand) {
+    return op.getTiedIndexingMap(opOperand).isIdentity();
+  });
+}
+
 namespace {
 
 template <typename TiledOp>
@@ -48,9 +493,13 @@ struct OpTilingPattern : public OpRewritePattern<TiledOp> {
   LogicalResult matchAndRewrite(TiledOp op,
                                 PatternRewriter &rewriter) const override {
     if (failed(filter.checkAndNotify(rewriter, op))) return failure();
-
-    // Clone operation so that existing op can be replaced easily.
-    auto clonedOp = cast<TiledOp>(rewriter.clone(*op.getOperation()));
+    if (isConsumedByTileLoops(op))
+      return rewriter.notifyMatchFailure(
+          op, "fused into the tile loops of its consumers instead");
+    if (options.loopType == linalg::LinalgTilingLoopType::ParallelLoops &&
+        op.hasTensorSemantics())
+      return rewriter.notifyMatchFailure(
+          op, "scf.parallel cannot carry tensor results");
 
     // Get rank and tile sizes.
     SmallVector<Value> tileSizes =
@@ -58,6 +507,14 @@ struct OpTilingPattern : public OpRewritePattern<TiledOp> {
     // Compute lower and upper bounds of the loop nest.
     SmallVector<Range> ranges = op.getLoopBounds(rewriter);
     assert(static_cast<int64_t>(tileSizes.size()) == ranges.size());
+    // Only parallel loops are tiled, the tiled implementation of an op
+    // processes its non-parallel dimensions as a whole.
+    SmallVector<StringRef> iteratorTypes = op.getLoopIteratorTypes();
+    for (auto it : llvm::enumerate(iteratorTypes)) {
+      if (it.value() == getParallelIteratorTypeName()) continue;
+      tileSizes[it.index()] =
+          rewriter.create<arith::ConstantIndexOp>(op.getLoc(), 0);
+    }
     SmallVector<Value> lbs, dims, allDims, steps;
     for (auto it : llvm::enumerate(ranges)) {
       allDims.push_back(it.value().size);
@@ -68,9 +525,25 @@ struct OpTilingPattern : public OpRewritePattern<TiledOp> {
       }
     }
 
-    // Generate loop nest: One loop per dimension.
-    SmallVector<Value> destOperand = op.getDestinationOperands(rewriter);
     Location loc = op->getLoc();
+    // Parallel loop types and ops on buffers create the tiled op in the loop
+    // body, directly on the outputs of the loop.
+    if (options.loopType != linalg::LinalgTilingLoopType::Loops ||
+        !op.hasTensorSemantics()) {
+      Operation *tiledOp = nullptr;
+      SmallVector<Value> results = buildParallelTileLoops(
+          rewriter, loc, op, options.loopType, lbs, /*ubs=*/dims, steps,
+          tileSizes, allDims, tiledOp);
+      filter.replaceLinalgTransformationFilter(rewriter, tiledOp);
+      rewriter.replaceOp(op, results);
+      return success();
+    }
+
+    // Generate loop nest: One loop per dimension. The op is tiled by swapping
+    // it with the slices of its results, see SliceOpTiledOpSwapPattern.
+    // Clone operation so that existing op can be replaced easily.
+    auto clonedOp = cast<TiledOp>(rewriter.clone(*op.getOperation()));
+    SmallVector<Value> destOperand = op.getDestinationOperands(rewriter);
     auto loopNest = mlir::scf::buildLoopNest(
         rewriter, loc, lbs, /*ubs=*/dims, steps, ValueRange(destOperand),
         [&](OpBuilder &b, Location loc, ValueRange localIvs,
@@ -83,17 +556,20 @@ struct OpTilingPattern : public OpRewritePattern<TiledOp> {
           // Create ExtractSliceOp: Extract a tile from the PadTensorOp.
           // Note: The PadTensorOp is located outside of the loop nest. It is
           // later moved inside by ExtractSliceOfPadTensorSwapPattern.
-          auto map =
-              AffineMap::getMultiDimIdentityMap(ranges.size(), b.getContext());
-          Value tiledOutput =
-              linalg::makeTiledShape(b, loc, clonedOp->getResult(0), tileSizes,
-                                     map, offsets, allDims, sizes);
-          auto sliceOp = tiledOutput.getDefiningOp<tensor::ExtractSliceOp>();
-          assert(sliceOp && "expected ExtractSliceOp");
-          // Insert the tile into the output tensor.
-          Value yieldValue =
-              insertSliceIntoTensor(b, loc, sliceOp, sliceOp, iterArgs[0]);
-          return scf::ValueVector({yieldValue});
+          scf::ValueVector yieldValues;
+          for (OpResult result : clonedOp->getResults()) {
+            AffineMap map = getResultTileMap(clonedOp, result);
+            Value tiledOutput =
+                linalg::makeTiledShape(b, loc, result, tileSizes, map, offsets,
+                                       allDims, sizes);
+            auto sliceOp = tiledOutput.getDefiningOp<tensor::ExtractSliceOp>();
+            assert(sliceOp && "expected ExtractSliceOp");
+            // Insert the tile into the output tensor.
+            yieldValues.push_back(insertSliceIntoTensor(
+                b, loc, sliceOp, sliceOp,
+                iterArgs[result.getResultNumber()]));
+          }
+          return yieldValues;
         });
 
     filter.replaceLinalgTransformationFilter(rewriter, op);
@@ -106,6 +582,60 @@ struct OpTilingPattern : public OpRewritePattern<TiledOp> {
   linalg::LinalgTransformationFilter filter;
 };
 
+/// Tile ops that update their destination at data-dependent positions, e.g.
+/// scatter. Their results cannot be sliced along the loops, so the tiled op is
+/// created directly in the loop body and updates the loop-carried destination.
+/// All loops are tiled, the loop nest executes the tiles in order independently
+/// of the loop type of the options since tiles may update the same positions.
+template <typename TiledOp>
+struct DestinationTilingPattern : public OpRewritePattern<TiledOp> {
+  DestinationTilingPattern(MLIRContext *context,
+                           linalg::LinalgTilingOptions opt,
+                           linalg::LinalgTransformationFilter filt)
+      : OpRewritePattern<TiledOp>(context), options(opt), filter(filt) {}
+
+  LogicalResult matchAndRewrite(TiledOp op,
+                                PatternRewriter &rewriter) const override {
+    if (failed(filter.checkAndNotify(rewriter, op))) return failure();
+
+    // Get rank and tile sizes.
+    SmallVector<Value> tileSizes =
+        options.tileSizeComputationFunction(rewriter, op);
+    // Compute lower and upper bounds of the loop nest.
+    SmallVector<Range> ranges = op.getLoopBounds(rewriter);
+    assert(static_cast<int64_t>(tileSizes.size()) == ranges.size());
+    SmallVector<Value> lbs, dims, allDims, steps;
+    for (auto it : llvm::enumerate(ranges)) {
+      allDims.push_back(it.value().size);
+      if (!isZero(tileSizes[it.index()])) {
+        lbs.push_back(it.value().offset);
+        dims.push_back(it.value().size);
+        steps.push_back(tileSizes[it.index()]);
+      }
+    }
+
+    // Generate loop nest: One loop per dimension.
+    SmallVector<Value> destOperand = op.getDestinationOperands(rewriter);
+    Location loc = op->getLoc();
+    Operation *tiledOp = nullptr;
+    auto loopNest = mlir::scf::buildLoopNest(
+        rewriter, loc, lbs, /*ubs=*/dims, steps, ValueRange(destOperand),
+        [&](OpBuilder &b, Location loc, ValueRange localIvs,
+            ValueRange iterArgs) -> scf::ValueVector {
+          return tileIntoDestinations(b, loc, op, localIvs, iterArgs,
+                                      tileSizes, allDims, tiledOp);
+        });
+
+    filter.replaceLinalgTransformationFilter(rewriter, tiledOp);
+    rewriter.replaceOp(op, loopNest.getResults());
+    return success();
+  }
+
+ private:
+  linalg::LinalgTilingOptions options;
+  linalg::LinalgTransformationFilter filter;
+};
+
 template <typename TiledOp>
 struct SliceOpTiledOpSwapPattern
     : public OpRewritePattern<tensor::ExtractSliceOp> {
@@ -121,10 +651,58 @@ struct SliceOpTiledOpSwapPattern
     auto sourceOp = sliceOp.source().getDefiningOp<TiledOp>();
     if (!sourceOp) return failure();
     if (failed(filter.checkAndNotify(rewriter, sourceOp))) return failure();
+    // Only slices of results indexed by all loops define the full tile. Slices
+    // of lower-rank results are replaced as siblings below.
+    OpResult sourceResult = sliceOp.source().cast<OpResult>();
+    if (!getResultTileMap(sourceOp, sourceResult).isIdentity())
+      return failure();
+    // A slice that tiles a non-parallel dimension, e.g. in the tile loop of a
+    // consumer tiling the sorted dimension, is not a tile of this op.
+    if (!coversNonParallelDims(sourceOp, sliceOp))
+      return rewriter.notifyMatchFailure(
+          sliceOp, "slice does not cover the non-parallel dimensions");
+    // Ops with multiple results produce all of their tiles at once. Replace
+    // the slices of the sibling results that extract the same tile as well.
+    // The tiled op is created before the first of these slices to ensure it
+    // dominates all their uses.
+    SmallVector<OpFoldResult> offsets = sliceOp.getMixedOffsets();
+    SmallVector<OpFoldResult> sizes = sliceOp.getMixedSizes();
+    SmallVector<OpFoldResult> strides = sliceOp.getMixedStrides();
+    SmallVector<tensor::ExtractSliceOp> siblingSlices;
+    Operation *insertionPoint = sliceOp;
+    for (OpResult result : sourceOp->getResults()) {
+      if (result == sourceResult) continue;
+      AffineMap map = getResultTileMap(sourceOp, result);
+      for (Operation *user : result.getUsers()) {
+        auto siblingSlice = dyn_cast<tensor::ExtractSliceOp>(user);
+        if (!siblingSlice || siblingSlice->getBlock() != sliceOp->getBlock() ||
+            siblingSlice.getMixedOffsets() !=
+                projectTileValues(offsets, map) ||
+            siblingSlice.getMixedSizes() != projectTileValues(sizes, map) ||
+            siblingSlice.getMixedStrides() != projectTileValues(strides, map))
+          continue;
+        siblingSlices.push_back(siblingSlice);
+        if (siblingSlice->isBeforeInBlock(insertionPoint))
+          insertionPoint = siblingSlice;
+      }
+    }
+    rewriter.setInsertionPoint(insertionPoint);
     Operation *tiledOp = sourceOp.getTiledImplementation(
-        rewriter, sourceOp.outputs(), sliceOp.getMixedOffsets(),
-        sliceOp.getMixedSizes());
-    rewriter.replaceOp(sliceOp, tiledOp->getResults());
+        rewriter, sourceOp.outputs(), offsets, sizes);
+    // Tiled implementations that process a dimension as a whole may infer a
+    // static size where the slice has a dynamic one.
+    auto replaceSlice = [&](tensor::ExtractSliceOp slice, Value tiledResult) {
+      if (tiledResult.getType() != slice.getType())
+        tiledResult = rewriter.create<tensor::CastOp>(
+            slice.getLoc(), slice.getType(), tiledResult);
+      rewriter.replaceOp(slice, tiledResult);
+    };
+    for (tensor::ExtractSliceOp siblingSlice : siblingSlices) {
+      unsigned resultNumber =
+          siblingSlice.source().cast<OpResult>().getResultNumber();
+      replaceSlice(siblingSlice, tiledOp->getResult(resultNumber));
+    }
+    replaceSlice(sliceOp, tiledOp->getResult(sourceResult.getResultNumber()));
     filter.replaceLinalgTransformationFilter(rewriter, sourceOp);
     filter.replaceLinalgTransformationFilter(rewriter, tiledOp);
     return success();
@@ -135,6 +713,425 @@ struct SliceOpTiledOpSwapPattern
   linalg::LinalgTransformationFilter filter;
 };
 
+/// Fuse a linalg producer into the tile loop of a LinalgExt consumer: the
+/// slice of a result of an elementwise op or a fill that is consumed by a
+/// LinalgExt op is replaced by the same op computing only that slice. The
+/// producer and its consumer then process a tile at a time instead of
+/// sweeping over the full tensors one after the other.
+struct SliceOpLinalgOpSwapPattern
+    : public OpRewritePattern<tensor::ExtractSliceOp> {
+  SliceOpLinalgOpSwapPattern(MLIRContext *context,
+                             linalg::LinalgTilingOptions opt,
+                             linalg::LinalgTransformationFilter filt)
+      : OpRewritePattern<tensor::ExtractSliceOp>(context),
+        options(opt),
+        filter(filt) {}
+
+  LogicalResult matchAndRewrite(tensor::ExtractSliceOp sliceOp,
+                                PatternRewriter &rewriter) const override {
+    auto producer = sliceOp.source().getDefiningOp<linalg::LinalgOp>();
+    if (!producer || !isFusableLinalgProducer(producer)) return failure();
+    if (failed(filter.checkAndNotify(rewriter, producer))) return failure();
+    if (llvm::none_of(sliceOp->getUsers(),
+                      [](Operation *user) { return isa<LinalgExtOp>(user); }))
+      return failure();
+    // The offsets and sizes of the slice are the offsets and sizes of the tile
+    // of the loops, which requires a full-rank slice with unit strides.
+    if (sliceOp.getSourceType().getRank() != sliceOp.getType().getRank() ||
+        llvm::any_of(sliceOp.getMixedStrides(), [](OpFoldResult stride) {
+          Optional<int64_t> cst = getConstantIntValue(stride);
+          return !cst || *cst != 1;
+        }))
+      return failure();
+
+    Location loc = sliceOp.getLoc();
+    rewriter.setInsertionPoint(sliceOp);
+    SmallVector<Value> offsets, sizes, sizeBounds;
+    for (OpFoldResult offset : sliceOp.getMixedOffsets())
+      offsets.push_back(getValueOrCreateConstantIndexOp(rewriter, loc, offset));
+    for (OpFoldResult size : sliceOp.getMixedSizes())
+      sizes.push_back(getValueOrCreateConstantIndexOp(rewriter, loc, size));
+    for (OpFoldResult dim : getMixedDims(rewriter, loc, sliceOp.source()))
+      sizeBounds.push_back(getValueOrCreateConstantIndexOp(rewriter, loc, dim));
+    SmallVector<Value> valuesToTile = llvm::to_vector(
+        llvm::map_range(producer.getInputAndOutputOperands(),
+                        [](OpOperand *opOperand) { return opOperand->get(); }));
+    SmallVector<Value> tiledOperands = linalg::makeTiledShapes(
+        rewriter, loc, producer, valuesToTile, offsets, sizes, sizeBounds);
+    SmallVector<Type> resultTypes;
+    for (OpOperand *opOperand : producer.getOutputTensorOperands()) {
+      resultTypes.push_back(
+          tiledOperands[opOperand->getOperandNumber()].getType());
+    }
+    Operation *tiledProducer =
+        producer.clone(rewriter, loc, resultTypes, tiledOperands);
+    unsigned resultNumber =
+        sliceOp.source().cast<OpResult>().getResultNumber();
+    rewriter.replaceOp(sliceOp, tiledProducer->getResult(resultNumber));
+    return success();
+  }
+
+ private:
+  linalg::LinalgTilingOptions options;
+  linalg::LinalgTransformationFilter filter;
+};
+
+/// Tile the scanned dimension of a linalg_ext.scan on tensors into a two-phase
+/// parallel scan:
+///   1. Every tile is scanned independently, starting from the neutral element
+///      of the combiner. The accumulator results, i.e. the totals of the tiles,
+///      are gathered in a tensor with one entry per tile.
+///   2. An exclusive scan of the tile totals, seeded with the accumulator of
+///      the op, computes the carry of every tile. Its accumulator result is the
+///      accumulator result of the op.
+///   3. The carry of every tile is combined with all elements of the tile.
+/// The iterations of the first and the last phase are independent and their
+/// loops are built with the loop type of the tiling options, e.g. a
+/// linalg.tiled_loop with a parallel iterator. Only the scan of the tile
+/// totals remains sequential. The combiner has to be associative and have a
+/// known neutral element. The parallel dimensions are expected to be tiled by
+/// `OpTilingPattern` beforehand.
+struct ScanOpTwoPhaseTilingPattern : public OpRewritePattern<ScanOp> {
+  ScanOpTwoPhaseTilingPattern(MLIRContext *context,
+                              linalg::LinalgTilingOptions opt,
+                              linalg::LinalgTransformationFilter filt)
+      : OpRewritePattern<ScanOp>(context), options(opt), filter(filt) {}
+
+  LogicalResult matchAndRewrite(ScanOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics()) return failure();
+    if (failed(filter.checkAndNotify(rewriter, op))) return failure();
+    if (options.loopType == linalg::LinalgTilingLoopType::ParallelLoops)
+      return rewriter.notifyMatchFailure(
+          op, "scf.parallel cannot carry tensor results");
+    Optional<Attribute> neutralAttr = getNeutralOfScanCombiner(rewriter, op);
+    if (!neutralAttr) return failure();
+
+    uint64_t scanDim = op.getScanDim();
+    Value tileSize = getLoopTileSize(rewriter, op, options, scanDim);
+    if (!tileSize) return failure();
+
+    Location loc = op.getLoc();
+    MLIRContext *context = op.getContext();
+    int64_t rank = op.getOperandRank();
+    Type elementType = op.getOperandType().getElementType();
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    SmallVector<OpFoldResult> dims = getMixedDims(rewriter, loc, op.input());
+    Value scanSize =
+        getValueOrCreateConstantIndexOp(rewriter, loc, dims[scanDim]);
+    OpFoldResult numTiles =
+        getNumTiles(rewriter, loc, dims[scanDim], tileSize);
+
+    // Offsets and sizes of the tile starting at `iv` and of its entry in the
+    // tensors of tile totals and carries.
+    AffineExpr d0, s0, s1;
+    bindDims(context, d0);
+    bindSymbols(context, s0, s1);
+    AffineMap minMap = AffineMap::get(1, 2, {s0, s1 - d0}, context);
+    SmallVector<OpFoldResult> strides(rank, rewriter.getIndexAttr(1));
+    auto getTile = [&](OpBuilder &b, Location loc, Value iv,
+                       SmallVector<OpFoldResult> &offsets,
+                       SmallVector<OpFoldResult> &sizes) {
+      offsets.assign(rank, b.getIndexAttr(0));
+      offsets[scanDim] = iv;
+      sizes.assign(dims.begin(), dims.end());
+      sizes[scanDim] = b.create<AffineMinOp>(loc, minMap,
+                                             ValueRange{iv, tileSize, scanSize})
+                           .getResult();
+    };
+    auto getTileEntry = [&](OpBuilder &b, Location loc, Value iv,
+                            SmallVector<OpFoldResult> &offsets,
+                            SmallVector<OpFoldResult> &sizes) {
+      offsets.assign(rank, b.getIndexAttr(0));
+      offsets[scanDim] =
+          b.create<arith::DivUIOp>(loc, iv, tileSize).getResult();
+      sizes.assign(dims.begin(), dims.end());
+      sizes[scanDim] = b.getIndexAttr(1);
+    };
+
+    // Phase 1: scan every tile starting from the neutral element.
+    SmallVector<OpFoldResult> accSizes(dims.begin(), dims.end());
+    accSizes.erase(accSizes.begin() + scanDim);
+    Value neutral = rewriter.create<arith::ConstantOp>(loc, *neutralAttr);
+    Value accInit =
+        rewriter.create<linalg::InitTensorOp>(loc, accSizes, elementType);
+    Value neutralAcc =
+        rewriter.create<linalg::FillOp>(loc, neutral, accInit).result();
+    SmallVector<OpFoldResult> totalsSizes(dims.begin(), dims.end());
+    totalsSizes[scanDim] = numTiles;
+    Value totalsInit =
+        rewriter.create<linalg::InitTensorOp>(loc, totalsSizes, elementType);
+    Operation *tileScan = nullptr;
+    SmallVector<Value> tileLoopResults = buildTensorTileLoop(
+        rewriter, loc, options.loopType, zero, scanSize, tileSize,
+        ValueRange{op.output(), totalsInit},
+        [&](OpBuilder &b, Location loc, Value iv,
+            ValueRange iterArgs) -> SmallVector<Value> {
+          SmallVector<OpFoldResult> offsets, sizes, entryOffsets, entrySizes;
+          getTile(b, loc, iv, offsets, sizes);
+          getTileEntry(b, loc, iv, entryOffsets, entrySizes);
+          Value inputTile = b.create<tensor::ExtractSliceOp>(
+              loc, op.input(), offsets, sizes, strides);
+          Value outputTile = b.create<tensor::ExtractSliceOp>(
+              loc, iterArgs[0], offsets, sizes, strides);
+          SmallVector<Type> resultTypes = {outputTile.getType(),
+                                           neutralAcc.getType()};
+          SmallVector<Value> operands = {inputTile, outputTile, neutralAcc};
+          tileScan = cast<LinalgExtOp>(op.getOperation())
+                         .clone(b, loc, resultTypes, operands);
+          Value output = b.create<tensor::InsertSliceOp>(
+              loc, tileScan->getResult(0), iterArgs[0], offsets, sizes,
+              strides);
+          Value totals = b.create<tensor::InsertSliceOp>(
+              loc, tileScan->getResult(1), iterArgs[1], entryOffsets,
+              entrySizes, strides);
+          return {output, totals};
+        });
+
+    // Phase 2: exclusive scan of the tile totals.
+    Value totals = tileLoopResults[1];
+    Value carriesInit =
+        rewriter.create<linalg::InitTensorOp>(loc, totalsSizes, elementType);
+    SmallVector<Type> resultTypes = {totals.getType(),
+                                     op.accumulator().getType()};
+    SmallVector<Value> operands = {totals, carriesInit, op.accumulator()};
+    auto carryScan = cast<ScanOp>(cast<LinalgExtOp>(op.getOperation())
+                                      .clone(rewriter, loc, resultTypes,
+                                             operands));
+    carryScan.inclusiveAttr(rewriter.getBoolAttr(false));
+
+    // Phase 3: combine the carry of every tile with all elements of the tile.
+    SmallVector<AffineExpr> carryExprs;
+    for (int64_t dim = 0; dim < rank; ++dim) {
+      carryExprs.push_back(static_cast<uint64_t>(dim) == scanDim
+                               ? getAffineConstantExpr(0, context)
+                               : getAffineDimExpr(dim, context));
+    }
+    SmallVector<AffineMap> indexingMaps = {
+        AffineMap::get(rank, /*symbolCount=*/0, carryExprs, context),
+        AffineMap::getMultiDimIdentityMap(rank, context)};
+    SmallVector<StringRef> iteratorTypes(rank, getParallelIteratorTypeName());
+    SmallVector<Value> carryLoopResults = buildTensorTileLoop(
+        rewriter, loc, options.loopType, zero, scanSize, tileSize,
+        ValueRange{tileLoopResults[0]},
+        [&](OpBuilder &b, Location loc, Value iv,
+            ValueRange iterArgs) -> SmallVector<Value> {
+          SmallVector<OpFoldResult> offsets, sizes, entryOffsets, entrySizes;
+          getTile(b, loc, iv, offsets, sizes);
+          getTileEntry(b, loc, iv, entryOffsets, entrySizes);
+          Value outputTile = b.create<tensor::ExtractSliceOp>(
+              loc, iterArgs[0], offsets, sizes, strides);
+          Value carry = b.create<tensor::ExtractSliceOp>(
+              loc, carryScan.getResult(0), entryOffsets, entrySizes, strides);
+          auto combineOp = b.create<linalg::GenericOp>(
+              loc, outputTile.getType(), ValueRange{carry},
+              ValueRange{outputTile}, indexingMaps, iteratorTypes,
+              [&](OpBuilder &nb, Location nloc, ValueRange args) {
+                nb.create<linalg::YieldOp>(
+                    nloc, cloneScanCombiner(nb, op, args[0], args[1]));
+              });
+          Value output = b.create<tensor::InsertSliceOp>(
+              loc, combineOp.getResult(0), iterArgs[0], offsets, sizes,
+              strides);
+          return {output};
+        });
+
+    filter.replaceLinalgTransformationFilter(rewriter, tileScan);
+    filter.replaceLinalgTransformationFilter(rewriter, carryScan);
+    rewriter.replaceOp(op, {carryLoopResults[0], carryScan.getResult(1)});
+    return success();
+  }
+
+ private:
+  linalg::LinalgTilingOptions options;
+  linalg::LinalgTransformationFilter filter;
+};
+
+/// Split the selected dimension of a linalg_ext.topk on tensors into tiles:
+///   1. Every tile selects its own top-k, starting from padding candidates:
+///      the last element of the comparator with the out-of-range index -1.
+///      The indices of the selected elements are offset by the position of
+///      the tile unless explicit indices are given. The per-tile results are
+///      concatenated along the selected dimension.
+///   2. A final top-k merges the concatenated per-tile results, with their
+///      indices, into the outputs of the op.
+/// Both top-k ops compare the indices on ties such that real elements are
+/// selected before padding, which only remains in the outputs if there are
+/// fewer than `k` elements. Explicit indices are expected to be non-negative.
+/// The iterations of the first phase are independent and its loop is built
+/// with the loop type of the tiling options. The final top-k only selects
+/// from `k` elements per tile. The comparator has to be a single comparison
+/// with a known last element. The parallel dimensions are expected to be tiled
+/// by `OpTilingPattern` beforehand.
+struct TopkOpSplitPattern : public OpRewritePattern<TopkOp> {
+  TopkOpSplitPattern(MLIRContext *context, linalg::LinalgTilingOptions opt,
+                     linalg::LinalgTransformationFilter filt)
+      : OpRewritePattern<TopkOp>(context), options(opt), filter(filt) {}
+
+  LogicalResult matchAndRewrite(TopkOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics()) return failure();
+    if (failed(filter.checkAndNotify(rewriter, op))) return failure();
+    if (options.loopType == linalg::LinalgTilingLoopType::ParallelLoops)
+      return rewriter.notifyMatchFailure(
+          op, "scf.parallel cannot carry tensor results");
+    Optional<Attribute> lastAttr = getLastOfTopkComparator(rewriter, op);
+    if (!lastAttr) return failure();
+
+    uint64_t dimension = op.getDimension();
+    Value tileSize = getLoopTileSize(rewriter, op, options, dimension);
+    if (!tileSize) return failure();
+
+    Location loc = op.getLoc();
+    MLIRContext *context = op.getContext();
+    int64_t rank = op.getInputRank();
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    SmallVector<OpFoldResult> dims = getMixedDims(rewriter, loc, op.values());
+    SmallVector<OpFoldResult> outputDims =
+        getMixedDims(rewriter, loc, op.outputValues());
+    Value size =
+        getValueOrCreateConstantIndexOp(rewriter, loc, dims[dimension]);
+    OpFoldResult k = outputDims[dimension];
+    Value kValue = getValueOrCreateConstantIndexOp(rewriter, loc, k);
+    OpFoldResult numTiles =
+        getNumTiles(rewriter, loc, dims[dimension], tileSize);
+
+    // The per-tile results are concatenated along the selected dimension.
+    SmallVector<OpFoldResult> partialSizes(outputDims);
+    auto staticK = k.dyn_cast<Attribute>();
+    auto staticNumTiles = numTiles.dyn_cast<Attribute>();
+    if (staticK && staticNumTiles) {
+      partialSizes[dimension] = rewriter.getIndexAttr(
+          staticK.cast<IntegerAttr>().getInt() *
+          staticNumTiles.cast<IntegerAttr>().getInt());
+    } else {
+      partialSizes[dimension] =
+          rewriter
+              .create<arith::MulIOp>(
+                  loc,
+                  getValueOrCreateConstantIndexOp(rewriter, loc, numTiles),
+                  kValue)
+              .getResult();
+    }
+    Type valueType = op.getInputType().getElementType();
+    Type indexType =
+        op.outputIndices().getType().cast<ShapedType>().getElementType();
+    Value partialValuesInit =
+        rewriter.create<linalg::InitTensorOp>(loc, partialSizes, valueType);
+    Value partialIndicesInit =
+        rewriter.create<linalg::InitTensorOp>(loc, partialSizes, indexType);
+
+    // Candidates of every tile: the last element and an out-of-range index.
+    Value last = rewriter.create<arith::ConstantOp>(loc, *lastAttr);
+    Attribute padAttr = rewriter.getIntegerAttr(indexType, -1);
+    Value padIndex = rewriter.create<arith::ConstantOp>(loc, padAttr);
+    Value candidateValues =
+        rewriter
+            .create<linalg::FillOp>(
+                loc, last,
+                rewriter.create<linalg::InitTensorOp>(loc, outputDims,
+                                                      valueType))
+            .result();
+    Value candidateIndices =
+        rewriter
+            .create<linalg::FillOp>(
+                loc, padIndex,
+                rewriter.create<linalg::InitTensorOp>(loc, outputDims,
+                                                      indexType))
+            .result();
+
+    // Phase 1: select the top-k of every tile.
+    AffineExpr d0, s0, s1;
+    bindDims(context, d0);
+    bindSymbols(context, s0, s1);
+    AffineMap minMap = AffineMap::get(1, 2, {s0, s1 - d0}, context);
+    SmallVector<OpFoldResult> strides(rank, rewriter.getIndexAttr(1));
+    SmallVector<AffineMap> indexingMaps = {
+        AffineMap::getMultiDimIdentityMap(rank, context)};
+    SmallVector<StringRef> iteratorTypes(rank, getParallelIteratorTypeName());
+    Operation *tileTopk = nullptr;
+    SmallVector<Value> tileLoopResults = buildTensorTileLoop(
+        rewriter, loc, options.loopType, zero, size, tileSize,
+        ValueRange{partialValuesInit, partialIndicesInit},
+        [&](OpBuilder &b, Location loc, Value iv,
+            ValueRange iterArgs) -> SmallVector<Value> {
+          SmallVector<OpFoldResult> offsets(rank, b.getIndexAttr(0));
+          offsets[dimension] = iv;
+          SmallVector<OpFoldResult> sizes(dims);
+          sizes[dimension] =
+              b.create<AffineMinOp>(loc, minMap,
+                                    ValueRange{iv, tileSize, size})
+                  .getResult();
+          SmallVector<Value> operands;
+          for (Value input : op.inputs()) {
+            operands.push_back(b.create<tensor::ExtractSliceOp>(
+                loc, input, offsets, sizes, strides));
+          }
+          operands.append({candidateValues, candidateIndices});
+          SmallVector<Type> resultTypes = {candidateValues.getType(),
+                                           candidateIndices.getType()};
+          tileTopk = cast<LinalgExtOp>(op.getOperation())
+                         .clone(b, loc, resultTypes, operands);
+          addTopkPaddingTieBreak(b, op, tileTopk, indexType, padAttr);
+          Value tileIndices = tileTopk->getResult(1);
+          if (!op.indices()) {
+            // Offset the positions within the tile by the tile position and
+            // keep the index of the padding out of range.
+            Value offset = iv;
+            if (!indexType.isIndex())
+              offset = b.create<arith::IndexCastOp>(loc, indexType, iv);
+            tileIndices =
+                b.create<linalg::GenericOp>(
+                     loc, tileIndices.getType(), ValueRange{},
+                     ValueRange{tileIndices}, indexingMaps, iteratorTypes,
+                     [&](OpBuilder &nb, Location nloc, ValueRange args) {
+                       Value isPad = nb.create<arith::CmpIOp>(
+                           nloc, arith::CmpIPredicate::eq, args[0], padIndex);
+                       Value index =
+                           nb.create<arith::AddIOp>(nloc, args[0], offset);
+                       index = nb.create<SelectOp>(nloc, isPad, args[0], index);
+                       nb.create<linalg::YieldOp>(nloc, index);
+                     })
+                    .getResult(0);
+          }
+
+          SmallVector<OpFoldResult> partialOffsets(rank, b.getIndexAttr(0));
+          Value tileIndex = b.create<arith::DivUIOp>(loc, iv, tileSize);
+          partialOffsets[dimension] =
+              b.create<arith::MulIOp>(loc, tileIndex, kValue).getResult();
+          Value partialValues = b.create<tensor::InsertSliceOp>(
+              loc, tileTopk->getResult(0), iterArgs[0], partialOffsets,
+              outputDims, strides);
+          Value partialIndices = b.create<tensor::InsertSliceOp>(
+              loc, tileIndices, iterArgs[1], partialOffsets, outputDims,
+              strides);
+          return {partialValues, partialIndices};
+        });
+
+    // Phase 2: merge the per-tile results into the outputs.
+    SmallVector<Value> operands = {tileLoopResults[0], tileLoopResults[1],
+                                   op.outputValues(), op.outputIndices()};
+    SmallVector<Type> resultTypes = {op.outputValues().getType(),
+                                     op.outputIndices().getType()};
+    Operation *mergeTopk = cast<LinalgExtOp>(op.getOperation())
+                               .clone(rewriter, loc, resultTypes, operands);
+    // The number of inputs changes if the op has no explicit indices.
+    mergeTopk->setAttr(
+        TopkOp::getOperandSegmentSizeAttr(),
+        rewriter.getI32VectorAttr({/*inputs=*/2, /*outputs=*/2}));
+    addTopkPaddingTieBreak(rewriter, op, mergeTopk, indexType, padAttr);
+
+    filter.replaceLinalgTransformationFilter(rewriter, tileTopk);
+    filter.replaceLinalgTransformationFilter(rewriter, mergeTopk);
+    rewriter.replaceOp(op, mergeTopk->getResults());
+    return success();
+  }
+
+ private:
+  linalg::LinalgTilingOptions options;
+  linalg::LinalgTransformationFilter filter;
+};
+
 struct LinalgExtTilingPass : public LinalgExtTilingBase<LinalgExtTilingPass> {
   LinalgExtTilingPass() = default;
   LinalgExtTilingPass(ArrayRef<int64_t> tileSizes) {
@@ -150,12 +1147,37 @@ void LinalgExtTilingPass::runOnOperation() {
 
   RewritePatternSet patterns(context);
 
-  auto options = linalg::LinalgTilingOptions().setTileSizes(tileSizes);
+  linalg::LinalgTilingLoopType tilingLoopType =
+      llvm::StringSwitch<linalg::LinalgTilingLoopType>(loopType.getValue())
+          .Case("parallel", linalg::LinalgTilingLoopType::ParallelLoops)
+          .Case("tiled_loop", linalg::LinalgTilingLoopType::TiledLoops)
+          .Default(linalg::LinalgTilingLoopType::Loops);
+  auto options = linalg::LinalgTilingOptions()
+                     .setTileSizes(tileSizes)
+                     .setLoopType(tilingLoopType);
   auto filter = linalg::LinalgTransformationFilter(
       ArrayRef<Identifier>{}, Identifier::get("tiled", context));
   patterns.insert<OpTilingPattern<linalg_ext::ReverseOp>,
-                  SliceOpTiledOpSwapPattern<linalg_ext::ReverseOp>>(
-      context, options, filter);
+                  SliceOpTiledOpSwapPattern<linalg_ext::ReverseOp>,
+                  OpTilingPattern<linalg_ext::SortOp>,
+                  SliceOpTiledOpSwapPattern<linalg_ext::SortOp>,
+                  OpTilingPattern<linalg_ext::ScanOp>,
+                  SliceOpTiledOpSwapPattern<linalg_ext::ScanOp>,
+                  OpTilingPattern<linalg_ext::GatherOp>,
+                  SliceOpTiledOpSwapPattern<linalg_ext::GatherOp>,
+                  DestinationTilingPattern<linalg_ext::ScatterOp>,
+                  OpTilingPattern<linalg_ext::TopkOp>,
+                  SliceOpTiledOpSwapPattern<linalg_ext::TopkOp>,
+                  OpTilingPattern<linalg_ext::FftOp>,
+                  SliceOpTiledOpSwapPattern<linalg_ext::FftOp>,
+                  SliceOpLinalgOpSwapPattern>(context, options, filter);
+  // The scanned dimension of scans and the selected dimension of top-k ops
+  // tiled along their parallel dimensions are split into two phases.
+  patterns.insert<ScanOpTwoPhaseTilingPattern, TopkOpSplitPattern>(
+      context, options,
+      linalg::LinalgTransformationFilter(
+          Identifier::get("tiled", context),
+          Identifier::get("split", context)));
   (void)applyPatternsAndFoldGreedily(funcOp, std::move(patterns));
 }
 
@@ -0,0 +1,515 @@
+//===- Vectorization.cpp - Vectorization of LinalgExt ops -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+#include "include/LinalgExt/LinalgExtOps.h"
+#include "include/LinalgExt/PassDetail.h"
+#include "include/LinalgExt/Passes.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Vector/VectorOps.h"
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#include <cmath>
+
+using namespace mlir;
+using namespace mlir::linalg_ext;
+
+//===----------------------------------------------------------------------===//
+// Utils.
+//===----------------------------------------------------------------------===//
+
+/// Return true if all operations of the scalar `region` can be applied
+/// elementwise to vectors, i.e. they are constants or elementwise operations on
+/// scalars that only use values defined in `region`.
+static bool isVectorizableRegion(Region &region) {
+  for (Operation &op : region.front().without_terminator()) {
+    if (op.hasTrait<OpTrait::ConstantLike>()) continue;
+    if (!op.hasTrait<OpTrait::Elementwise>() || op.getNumRegions() != 0)
+      return false;
+    for (Value operand : op.getOperands()) {
+      if (operand.getParentRegion() != &region) return false;
+      if (!operand.getType().isIntOrIndexOrFloat()) return false;
+    }
+  }
+  return true;
+}
+
+/// Clone the scalar `region` on vectors of `size` elements. `args` hold the
+/// vectorized region arguments. Return the vectorized yielded value.
+static Value vectorizeRegion(OpBuilder &b, Location loc, Region &region,
+                             int64_t size, ValueRange args) {
+  Block &block = region.front();
+  BlockAndValueMapping bvm;
+  bvm.map(block.getArguments(), args);
+  for (Operation &op : block.without_terminator()) {
+    if (op.hasTrait<OpTrait::ConstantLike>()) {
+      Operation *scalar = b.clone(op);
+      Value result = scalar->getResult(0);
+      auto vectorType = VectorType::get({size}, result.getType());
+      bvm.map(op.getResult(0),
+              b.create<vector::BroadcastOp>(loc, vectorType, result));
+      continue;
+    }
+    OperationState state(loc, op.getName());
+    state.addAttributes(op.getAttrs());
+    for (Value operand : op.getOperands())
+      state.addOperands(bvm.lookup(operand));
+    for (Type type : op.getResultTypes())
+      state.addTypes(VectorType::get({size}, type));
+    Operation *vectorOp = b.createOperation(state);
+    bvm.map(op.getResults(), vectorOp->getResults());
+  }
+  return bvm.lookup(block.getTerminator()->getOperand(0));
+}
+
+/// Return the values of the `indices` of a scatter or gather for the batch
+/// entry `batch` as indices of the indexed operand, padded with zeros for the
+/// slice dimensions.
+static SmallVector<Value> getIndexedPosition(OpBuilder &b, Location loc,
+                                             Value indices, Value batch,
+                                             int64_t indexedRank) {
+  int64_t indexDepth = indices.getType().cast<ShapedType>().getShape().back();
+  Value zero = b.create<arith::ConstantIndexOp>(loc, 0);
+  SmallVector<Value> position;
+  for (int64_t i = 0; i < indexDepth; ++i) {
+    Value dim = b.create<arith::ConstantIndexOp>(loc, i);
+    Value index =
+        b.create<tensor::ExtractOp>(loc, indices, ValueRange{batch, dim});
+    if (!index.getType().isIndex())
+      index = b.create<arith::IndexCastOp>(loc, b.getIndexType(), index);
+    position.push_back(index);
+  }
+  position.resize(indexedRank, zero);
+  return position;
+}
+
+//===----------------------------------------------------------------------===//
+// ReverseOp
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/// Lower a linalg_ext.reverse of a small static tile to a vector transfer of
+/// the whole tile, vector.shuffle lane reversals and a vector transfer back.
+/// Tiles that are a single row along the innermost dimension are read as 1-D
+/// vectors such that the reversal is a single lane permutation (e.g. vpermps
+/// on AVX2 and AVX-512). Otherwise, every reversed dimension is transposed to
+/// the front of the vector, reversed by a shuffle and transposed back.
+struct ReverseOpVectorizationPattern : public OpRewritePattern<ReverseOp> {
+  ReverseOpVectorizationPattern(MLIRContext *context, int64_t maxSize)
+      : OpRewritePattern<ReverseOp>(context), maxSize(maxSize) {}
+
+  LogicalResult matchAndRewrite(ReverseOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics()) return failure();
+    ShapedType operandType = op.getOperandType();
+    if (!operandType.hasStaticShape() ||
+        operandType.getNumElements() > maxSize ||
+        operandType.getRank() == 0)
+      return failure();
+    Type elementType = operandType.getElementType();
+    if (!elementType.isIntOrIndexOrFloat()) return failure();
+
+    // Reversing dimensions of size 1 is a no-op.
+    ArrayRef<int64_t> shape = operandType.getShape();
+    int64_t rank = operandType.getRank();
+    SmallVector<int64_t> dims;
+    for (int64_t dim : op.dims())
+      if (shape[dim] != 1) dims.push_back(dim);
+
+    Location loc = op.getLoc();
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    SmallVector<Value> indices(rank, zero);
+    auto getReversal = [](int64_t size) {
+      SmallVector<int64_t> reversal;
+      for (int64_t i = size - 1; i >= 0; --i) reversal.push_back(i);
+      return reversal;
+    };
+
+    // A row along the innermost dimension is reversed as a 1-D vector.
+    bool isRow = llvm::all_of(shape.drop_back(),
+                              [](int64_t size) { return size == 1; });
+    Value vector;
+    if (isRow) {
+      auto vectorType = VectorType::get({shape.back()}, elementType);
+      vector = rewriter.create<vector::TransferReadOp>(loc, vectorType,
+                                                       op.input(), indices);
+      if (!dims.empty()) {
+        vector = rewriter.create<vector::ShuffleOp>(
+            loc, vector, vector, getReversal(shape.back()));
+      }
+    } else {
+      auto vectorType = VectorType::get(shape, elementType);
+      vector = rewriter.create<vector::TransferReadOp>(loc, vectorType,
+                                                       op.input(), indices);
+      for (int64_t dim : dims) {
+        // vector.shuffle permutes the outermost dimension.
+        SmallVector<int64_t> toFront = {dim}, fromFront;
+        for (int64_t i = 0; i < rank; ++i)
+          if (i != dim) toFront.push_back(i);
+        for (int64_t i = 0; i < rank; ++i)
+          fromFront.push_back(i == dim ? 0 : (i < dim ? i + 1 : i));
+        if (dim != 0)
+          vector = rewriter.create<vector::TransposeOp>(loc, vector, toFront);
+        vector = rewriter.create<vector::ShuffleOp>(loc, vector, vector,
+                                                    getReversal(shape[dim]));
+        if (dim != 0)
+          vector =
+              rewriter.create<vector::TransposeOp>(loc, vector, fromFront);
+      }
+    }
+
+    Value result = rewriter
+                       .create<vector::TransferWriteOp>(loc, vector,
+                                                        op.output(), indices)
+                       .result();
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+ private:
+  int64_t maxSize;
+};
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// SortOp
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/// Lower a linalg_ext.sort that sorts a single small row to a vectorized
+/// odd-even transposition sorting network. Every stage of the network compares
+/// disjoint pairs of neighboring lanes: a vector.shuffle swaps the lanes of
+/// each pair, the comparator is evaluated on whole vectors and vector selects
+/// keep the ordered elements. Rows are usually obtained by tiling all other
+/// dimensions by 1 with `linalg-ext-tiling`.
+struct SortOpVectorizationPattern : public OpRewritePattern<SortOp> {
+  SortOpVectorizationPattern(MLIRContext *context, int64_t maxSize)
+      : OpRewritePattern<SortOp>(context), maxSize(maxSize) {}
+
+  LogicalResult matchAndRewrite(SortOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics()) return failure();
+
+    uint64_t sortDim = op.getSortDim();
+    ShapedType operandType = op.getOperandType(0);
+    if (!operandType.hasStaticShape()) return failure();
+    int64_t size = operandType.getDimSize(sortDim);
+    if (size < 2 || size > maxSize) return failure();
+    for (auto dim : llvm::enumerate(operandType.getShape()))
+      if (dim.index() != sortDim && dim.value() != 1) return failure();
+    for (Value output : op.outputs()) {
+      Type elementType = output.getType().cast<ShapedType>().getElementType();
+      if (!elementType.isIntOrIndexOrFloat()) return failure();
+    }
+    if (!isVectorizableRegion(op.region())) return failure();
+
+    // Read every operand as a 1-D vector along the sorted dimension.
+    Location loc = op.getLoc();
+    int64_t rank = op.getOperandRank();
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    SmallVector<Value> indices(rank, zero);
+    AffineMap map =
+        AffineMap::get(rank, /*symbolCount=*/0,
+                       rewriter.getAffineDimExpr(sortDim), op.getContext());
+    SmallVector<Value> vectors;
+    for (Value output : op.outputs()) {
+      Type elementType = output.getType().cast<ShapedType>().getElementType();
+      auto vectorType = VectorType::get({size}, elementType);
+      vectors.push_back(rewriter.create<vector::TransferReadOp>(
+          loc, vectorType, output, indices, map));
+    }
+
+    // An odd-even transposition network sorts `size` elements in `size`
+    // stages. Stage `s` compares the lanes `i` and `i + 1` for all `i` with
+    // the parity of `s`.
+    auto maskType = VectorType::get({size}, rewriter.getI1Type());
+    for (int64_t stage = 0; stage < size; ++stage) {
+      SmallVector<int64_t> partner(size);
+      SmallVector<bool> isLower(size, false);
+      for (int64_t i = 0; i < size; ++i) partner[i] = i;
+      for (int64_t i = stage % 2; i + 1 < size; i += 2) {
+        partner[i] = i + 1;
+        partner[i + 1] = i;
+        isLower[i] = true;
+      }
+      Value lowerMask = rewriter.create<arith::ConstantOp>(
+          loc, DenseElementsAttr::get(maskType, isLower));
+
+      SmallVector<Value> partners;
+      for (Value vector : vectors)
+        partners.push_back(
+            rewriter.create<vector::ShuffleOp>(loc, vector, vector, partner));
+
+      // The lower lane of a pair keeps its element if it is ordered before the
+      // element of the upper lane and vice versa. Lanes without a partner are
+      // their own partner and thus remain unchanged.
+      SmallVector<Value> lowerArgs, upperArgs;
+      for (auto it : llvm::zip(vectors, partners)) {
+        lowerArgs.append({std::get<0>(it), std::get<1>(it)});
+        upperArgs.append({std::get<1>(it), std::get<0>(it)});
+      }
+      Value lowerKeeps =
+          vectorizeRegion(rewriter, loc, op.region(), size, lowerArgs);
+      Value upperKeeps =
+          vectorizeRegion(rewriter, loc, op.region(), size, upperArgs);
+      Value keep =
+          rewriter.create<SelectOp>(loc, lowerMask, lowerKeeps, upperKeeps);
+      for (unsigned i = 0, e = vectors.size(); i < e; ++i)
+        vectors[i] =
+            rewriter.create<SelectOp>(loc, keep, vectors[i], partners[i]);
+    }
+
+    SmallVector<Value> results;
+    for (auto it : llvm::zip(vectors, op.outputs())) {
+      results.push_back(rewriter
+                            .create<vector::TransferWriteOp>(
+                                loc, std::get<0>(it), std::get<1>(it), indices,
+                                map)
+                            .result());
+    }
+    rewriter.replaceOp(op, results);
+    return success();
+  }
+
+ private:
+  int64_t maxSize;
+};
+
+//===----------------------------------------------------------------------===//
+// GatherOp and ScatterOp
+//===----------------------------------------------------------------------===//
+
+/// Lower a linalg_ext.gather of 1-D slices with a static size to a loop over
+/// the batch that copies every slice with a single vector transfer. Gathering
+/// whole rows with contiguous vector loads is the common case of embedding
+/// lookups and avoids element-wise hardware gathers.
+struct GatherOpVectorizationPattern : public OpRewritePattern<GatherOp> {
+  using OpRewritePattern<GatherOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(GatherOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics()) return failure();
+    ShapedType outputType = op.getOutputType();
+    if (op.getOutputSliceRank() != 1 || outputType.isDynamicDim(1))
+      return failure();
+
+    Location loc = op.getLoc();
+    auto vectorType = VectorType::get({outputType.getDimSize(1)},
+                                      outputType.getElementType());
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value batchSize =
+        rewriter.createOrFold<tensor::DimOp>(loc, op.output(), zero);
+    int64_t sourceRank = op.getSourceType().getRank();
+    auto loop = rewriter.create<scf::ForOp>(
+        loc, zero, batchSize, one, ValueRange{op.output()},
+        [&](OpBuilder &b, Location loc, Value batch, ValueRange iterArgs) {
+          SmallVector<Value> position =
+              getIndexedPosition(b, loc, op.indices(), batch, sourceRank);
+          Value slice = b.create<vector::TransferReadOp>(loc, vectorType,
+                                                         op.source(), position);
+          Value output = b.create<vector::TransferWriteOp>(
+                              loc, slice, iterArgs[0], ValueRange{batch, zero})
+                             .result();
+          b.create<scf::YieldOp>(loc, output);
+        });
+    rewriter.replaceOp(op, loop.getResults());
+    return success();
+  }
+};
+
+/// Lower a linalg_ext.scatter of 1-D slices with a static size to a loop over
+/// the batch that reads every update and the original slice it targets with
+/// vector transfers, combines them with the vectorized combiner and writes the
+/// result back. The batch entries are processed in order, which preserves the
+/// semantics of duplicate indices.
+struct ScatterOpVectorizationPattern : public OpRewritePattern<ScatterOp> {
+  using OpRewritePattern<ScatterOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(ScatterOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics()) return failure();
+    ShapedType updateType = op.getUpdateType();
+    if (op.getUpdateSliceRank() != 1 || updateType.isDynamicDim(1))
+      return failure();
+    if (!isVectorizableRegion(op.region())) return failure();
+
+    Location loc = op.getLoc();
+    int64_t size = updateType.getDimSize(1);
+    auto vectorType = VectorType::get({size}, updateType.getElementType());
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value batchSize =
+        rewriter.createOrFold<tensor::DimOp>(loc, op.updates(), zero);
+    int64_t originalRank = op.getOriginalType().getRank();
+    auto loop = rewriter.create<scf::ForOp>(
+        loc, zero, batchSize, one, ValueRange{op.original()},
+        [&](OpBuilder &b, Location loc, Value batch, ValueRange iterArgs) {
+          SmallVector<Value> position =
+              getIndexedPosition(b, loc, op.indices(), batch, originalRank);
+          Value update = b.create<vector::TransferReadOp>(
+              loc, vectorType, op.updates(), ValueRange{batch, zero});
+          Value original = b.create<vector::TransferReadOp>(
+              loc, vectorType, iterArgs[0], position);
+          Value combined = vectorizeRegion(b, loc, op.region(), size,
+                                           ValueRange{update, original});
+          Value result = b.create<vector::TransferWriteOp>(
+                              loc, combined, iterArgs[0], position)
+                             .result();
+          b.create<scf::YieldOp>(loc, result);
+        });
+    rewriter.replaceOp(op, loop.getResults());
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// FftOp
+//===----------------------------------------------------------------------===//
+
+/// Lower a linalg_ext.fft stage with a constant stage on a single row of
+/// static size to vector operations. vector.shuffle ops split the row into the
+/// lower and upper halves of all butterflies, which are combined elementwise
+/// with the twiddle factors and interleaved back into the row. Without
+/// coefficient operands, the twiddle factors are vector constants. The
+/// transfers of consecutive stages fold away such that the stages of a row
+/// remain in registers.
+struct FftOpVectorizationPattern : public OpRewritePattern<FftOp> {
+  using OpRewritePattern<FftOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(FftOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasTensorSemantics()) return failure();
+    auto stageOp = op.getStage().getDefiningOp<arith::ConstantIndexOp>();
+    if (!stageOp) return failure();
+    ShapedType operandType = op.getOperandType();
+    if (!operandType.hasStaticShape()) return failure();
+    for (int64_t size : operandType.getShape().drop_back())
+      if (size != 1) return failure();
+    int64_t length = op.getFftLength();
+    int64_t stage = stageOp.value();
+    if (stage < 1 || length < (int64_t(1) << stage)) return failure();
+    int64_t groupSize = int64_t(1) << stage;
+    int64_t halfGroupSize = groupSize / 2;
+    if (op.hasCoeff()) {
+      for (Value coeff : {op.getRealCoeff(), op.getImagCoeff()}) {
+        auto coeffType = coeff.getType().cast<ShapedType>();
+        if (!coeffType.isa<RankedTensorType>() ||
+            coeffType.getShape() != ArrayRef<int64_t>(halfGroupSize))
+          return failure();
+      }
+    }
+
+    // Lane i of the halves holds butterfly i, whose lower element is at
+    // `lower[i]` in the row and whose upper element is `halfGroupSize` after.
+    int64_t numButterflies = length / 2;
+    SmallVector<int64_t> lower, upper, twiddle, interleave(length);
+    for (int64_t k = 0; k < length; k += groupSize) {
+      for (int64_t j = 0; j < halfGroupSize; ++j) {
+        interleave[k + j] = lower.size();
+        interleave[k + j + halfGroupSize] = numButterflies + lower.size();
+        lower.push_back(k + j);
+        upper.push_back(k + j + halfGroupSize);
+        twiddle.push_back(j);
+      }
+    }
+
+    Location loc = op.getLoc();
+    Type elementType = operandType.getElementType();
+    auto rowType = VectorType::get({length}, elementType);
+    auto halfType = VectorType::get({numButterflies}, elementType);
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    SmallVector<Value> indices(op.getOperandRank(), zero);
+    Value re = rewriter.create<vector::TransferReadOp>(loc, rowType,
+                                                       op.getReal(), indices);
+    Value im = rewriter.create<vector::TransferReadOp>(loc, rowType,
+                                                       op.getImag(), indices);
+
+    // Twiddle factors of every butterfly.
+    Value wRe, wIm;
+    if (op.hasCoeff()) {
+      auto coeffType = VectorType::get({halfGroupSize}, elementType);
+      Value coeffRe = rewriter.create<vector::TransferReadOp>(
+          loc, coeffType, op.getRealCoeff(), zero);
+      Value coeffIm = rewriter.create<vector::TransferReadOp>(
+          loc, coeffType, op.getImagCoeff(), zero);
+      wRe = rewriter.create<vector::ShuffleOp>(loc, coeffRe, coeffRe, twiddle);
+      wIm = rewriter.create<vector::ShuffleOp>(loc, coeffIm, coeffIm, twiddle);
+    } else {
+      SmallVector<Attribute> twiddleRe, twiddleIm;
+      for (int64_t j : twiddle) {
+        double angle = 2 * llvm::numbers::pi * j / groupSize;
+        twiddleRe.push_back(rewriter.getFloatAttr(elementType, cos(angle)));
+        twiddleIm.push_back(rewriter.getFloatAttr(elementType, -sin(angle)));
+      }
+      wRe = rewriter.create<arith::ConstantOp>(
+          loc, DenseElementsAttr::get(halfType, twiddleRe));
+      wIm = rewriter.create<arith::ConstantOp>(
+          loc, DenseElementsAttr::get(halfType, twiddleIm));
+    }
+
+    // Butterflies: t = w * v, lower = u + t, upper = u - t.
+    Value uRe = rewriter.create<vector::ShuffleOp>(loc, re, re, lower);
+    Value uIm = rewriter.create<vector::ShuffleOp>(loc, im, im, lower);
+    Value vRe = rewriter.create<vector::ShuffleOp>(loc, re, re, upper);
+    Value vIm = rewriter.create<vector::ShuffleOp>(loc, im, im, upper);
+    Value tRe = rewriter.create<arith::SubFOp>(
+        loc, rewriter.create<arith::MulFOp>(loc, wRe, vRe),
+        rewriter.create<arith::MulFOp>(loc, wIm, vIm));
+    Value tIm = rewriter.create<arith::AddFOp>(
+        loc, rewriter.create<arith::MulFOp>(loc, wRe, vIm),
+        rewriter.create<arith::MulFOp>(loc, wIm, vRe));
+    Value lowerRe = rewriter.create<arith::AddFOp>(loc, uRe, tRe);
+    Value lowerIm = rewriter.create<arith::AddFOp>(loc, uIm, tIm);
+    Value upperRe = rewriter.create<arith::SubFOp>(loc, uRe, tRe);
+    Value upperIm = rewriter.create<arith::SubFOp>(loc, uIm, tIm);
+    re = rewriter.create<vector::ShuffleOp>(loc, lowerRe, upperRe, interleave);
+    im = rewriter.create<vector::ShuffleOp>(loc, lowerIm, upperIm, interleave);
+
+    Value resultRe =
+        rewriter.create<vector::TransferWriteOp>(loc, re, op.getReal(), indices)
+            .result();
+    Value resultIm =
+        rewriter.create<vector::TransferWriteOp>(loc, im, op.getImag(), indices)
+            .result();
+    rewriter.replaceOp(op, {resultRe, resultIm});
+    return success();
+  }
+};
+
+struct LinalgExtVectorizationPass
+    : public LinalgExtVectorizationBase<LinalgExtVectorizationPass> {
+  void runOnOperation() override;
+};
+}  // namespace
+
+void LinalgExtVectorizationPass::runOnOperation() {
+  FuncOp funcOp = getOperation();
+  MLIRContext *context = funcOp.getContext();
+
+  RewritePatternSet patterns(context);
+  patterns.insert<ReverseOpVectorizationPattern>(context,
+                                                maxReverseVectorSize);
+  patterns.insert<SortOpVectorizationPattern>(context, maxSortingNetworkSize);
+  patterns.insert<FftOpVectorizationPattern, GatherOpVectorizationPattern,
+                  ScatterOpVectorizationPattern>(context);
+  (void)applyPatternsAndFoldGreedily(funcOp, std::move(patterns));
+}
+
+std::unique_ptr<OperationPass<FuncOp>>
+mlir::linalg_ext::createLinalgExtVectorizationPass() {
+  return std::make_unique<LinalgExtVectorizationPass>();
+}
@@ -9,6 +9,7 @@
 #include "PassDetail.h"
 #include "Passes.h"
 #include "Transforms.h"
+#include "include/LinalgExt/BufferizableOpInterfaceImpl.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
 #include "mlir/Conversion/LinalgToLLVM/LinalgToLLVM.h"
 #include "mlir/Conversion/MathToLLVM/MathToLLVM.h"
@@ -108,14 +109,6 @@ void LinalgTensorCodegenDriverPass::runLowerToLLVM() {
   });
 }
 
-/// Return the neutral element as a new Value.
-/// For now, just assume it is the zero of type.
-/// In the future, it should be the zero of type + op.
-static Value getNeutralOfLinalgOp(OpBuilder &b, OpOperand &op) {
-  auto t = getElementTypeOrSelf(op.get().getType());
-  return b.create<ConstantOp>(op.getOwner()->getLoc(), t, b.getZeroAttr(t));
-}
-
 /// Collect all Linalg ops, they must all have tensor semantics.
 /// For now this just fuses everything.
 // TODO: finer control.
@@ -369,6 +362,7 @@ void LinalgTensorCodegenDriverPass::getDependentDialects(
       registerBufferizableOpInterfaceExternalModels(registry);
   linalg::comprehensive_bufferize::linalg_ext::
       registerBufferizableOpInterfaceExternalModels(registry);
+  ::mlir::linalg_ext::registerBufferizableOpInterfaceExternalModels(registry);
 }
 
 std::unique_ptr<OperationPass<ModuleOp>>
@@ -0,0 +1,114 @@
+//===- ReductionUtils.cpp - Utilities for Linalg reductions ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements helpers to inspect the combiner of Linalg reductions
+// and to materialize their neutral element, e.g. for padding or for
+// initializing partial reduction results.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Transforms.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "mlir/Analysis/SliceAnalysis.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+Operation *mlir::linalg::getCombinerOfLinalgOutput(LinalgOp linalgOp,
+                                                   unsigned outputPos) {
+  // Only single combiner operations are supported for now.
+  SmallVector<Operation *, 4> combinerOps;
+  if (!matchReduction(linalgOp.getRegionOutputArgs(), outputPos,
+                      combinerOps) ||
+      combinerOps.size() != 1)
+    return nullptr;
+  return combinerOps.front();
+}
+
+/// Return the combiner that consumes `opOperand`. For an output operand, this
+/// is the operation that reduces into the output. For an input operand, this
+/// is the combiner of an output if the input is directly combined into that
+/// output without any intermediate computation (e.g. the input of a max-pool).
+/// Return nullptr otherwise.
+static Operation *getCombinerOfLinalgOperand(OpOperand &opOperand) {
+  auto linalgOp = dyn_cast<LinalgOp>(opOperand.getOwner());
+  if (!linalgOp) return nullptr;
+
+  unsigned numInputs = linalgOp.getNumInputs();
+  if (opOperand.getOperandNumber() >= numInputs)
+    return getCombinerOfLinalgOutput(linalgOp,
+                                     opOperand.getOperandNumber() - numInputs);
+
+  Block *body = linalgOp.getBlock();
+  if (!body || opOperand.getOperandNumber() >= body->getNumArguments())
+    return nullptr;
+  BlockArgument bbArg = body->getArgument(opOperand.getOperandNumber());
+  if (!bbArg.hasOneUse()) return nullptr;
+  Operation *user = *bbArg.getUsers().begin();
+  for (unsigned outputPos : llvm::seq<unsigned>(0, linalgOp.getNumOutputs()))
+    if (getCombinerOfLinalgOutput(linalgOp, outputPos) == user) return user;
+  return nullptr;
+}
+
+Optional<Attribute> mlir::linalg::getNeutralOfCombiner(OpBuilder &b,
+                                                       Operation *combiner,
+                                                       Type type) {
+  if (!combiner) return llvm::None;
+
+  // Floating point neutral elements.
+  if (auto floatType = type.dyn_cast<FloatType>()) {
+    const llvm::fltSemantics &semantics = floatType.getFloatSemantics();
+    return TypeSwitch<Operation *, Optional<Attribute>>(combiner)
+        .Case<arith::AddFOp>(
+            [&](auto op) -> Attribute { return b.getFloatAttr(type, 0.0); })
+        .Case<arith::MulFOp>(
+            [&](auto op) -> Attribute { return b.getFloatAttr(type, 1.0); })
+        .Case<MaxFOp>([&](auto op) -> Attribute {
+          return b.getFloatAttr(type,
+                                APFloat::getInf(semantics, /*Negative=*/true));
+        })
+        .Case<MinFOp>([&](auto op) -> Attribute {
+          return b.getFloatAttr(type,
+                                APFloat::getInf(semantics, /*Negative=*/false));
+        })
+        .Default([](Operation *) { return llvm::None; });
+  }
+
+  // Integer neutral elements.
+  if (auto intType = type.dyn_cast<IntegerType>()) {
+    unsigned width = intType.getWidth();
+    return TypeSwitch<Operation *, Optional<Attribute>>(combiner)
+        .Case<arith::AddIOp, arith::OrIOp, arith::XOrIOp, MaxUIOp>(
+            [&](auto op) -> Attribute { return b.getIntegerAttr(type, 0); })
+        .Case<arith::MulIOp>(
+            [&](auto op) -> Attribute { return b.getIntegerAttr(type, 1); })
+        .Case<arith::AndIOp, MinUIOp>([&](auto op) -> Attribute {
+          return b.getIntegerAttr(type, APInt::getAllOnes(width));
+        })
+        .Case<MaxSIOp>([&](auto op) -> Attribute {
+          return b.getIntegerAttr(type, APInt::getSignedMinValue(width));
+        })
+        .Case<MinSIOp>([&](auto op) -> Attribute {
+          return b.getIntegerAttr(type, APInt::getSignedMaxValue(width));
+        })
+        .Default([](Operation *) { return llvm::None; });
+  }
+
+  return llvm::None;
+}
+
+Value mlir::linalg::getNeutralOfLinalgOp(OpBuilder &b, OpOperand &op) {
+  auto t = getElementTypeOrSelf(op.get().getType());
+  Attribute neutral = b.getZeroAttr(t);
+  Optional<Attribute> combinerNeutral =
+      getNeutralOfCombiner(b, getCombinerOfLinalgOperand(op), t);
+  if (combinerNeutral.hasValue()) neutral = *combinerNeutral;
+  return b.create<ConstantOp>(op.getOwner()->getLoc(), t, neutral);
+}
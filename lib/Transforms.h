@@ -34,6 +34,21 @@ void populateDistributeTiledLoopPattern(
 
 void populateTiledLoopToAsyncPatterns(OwningRewritePatternList &patterns);
 
+/// Return the unique operation that combines the region argument of the
+/// `outputPos`-th output of `linalgOp` with the reduced value, or nullptr if
+/// the output is not updated by a single recognized combiner.
+Operation *getCombinerOfLinalgOutput(LinalgOp linalgOp, unsigned outputPos);
+
+/// Return the neutral element of `combiner` for elements of `type`, e.g. zero
+/// for additions, one for multiplications and -inf for floating point maxima.
+/// Return llvm::None if `combiner` is null or not a known reduction operation.
+Optional<Attribute> getNeutralOfCombiner(OpBuilder &b, Operation *combiner,
+                                         Type type);
+
+/// Return the neutral element of the reduction that consumes `op` as a new
+/// Value. Fall back to the zero of type if the combiner cannot be inferred.
+Value getNeutralOfLinalgOp(OpBuilder &b, OpOperand &op);
+
 }  // namespace linalg
 }  // namespace mlir
 
@@ -12,11 +12,13 @@ from typing import Sequence, Optional
 import numpy as np
 
 from mlir.ir import *
-from mlir.dialects import arith, builtin, linalg, scf, std
+from mlir.dialects import arith, builtin, linalg, memref, scf, std
 from mlir.dialects.linalg.opdsl.lang import OperandKind
 from mlir.execution_engine import *
 from mlir.runtime import *
 
+from .compile_timings import CompileTimings
+from .target import host_target
 from .transforms import *
 
 f16 = "f16"
@@ -80,63 +82,69 @@ def attach_inplaceable_attributes(func: builtin.FuncOp,
 def attach_passthrough(func: builtin.FuncOp,
                        extras: Sequence[Attribute] = [],
                        avx512: bool = False):
+  """Attach the LLVM target attributes of the host to `func`.
+
+  `avx512` requests 512-bit vectors; it only takes effect on AVX-512 hosts.
+  """
   attributes = extras[:]
-  if avx512:
+  for key, value in host_target().passthrough(avx512=avx512):
     attributes.append(
-        ArrayAttr.get(
-            [StringAttr.get("target-cpu"),
-             StringAttr.get("skylake-avx512")]))
-    attributes.append(
-        ArrayAttr.get(
-            [StringAttr.get("prefer-vector-width"),
-             StringAttr.get("512")]))
-  else:
-    attributes.append(
-        ArrayAttr.get(
-            [StringAttr.get("target-cpu"),
-             StringAttr.get("broadwell")]))
-    attributes.append(
-        ArrayAttr.get(
-            [StringAttr.get("prefer-vector-width"),
-             StringAttr.get("256")]))
+        ArrayAttr.get([StringAttr.get(key),
+                       StringAttr.get(value)]))
   func.attributes["passthrough"] = ArrayAttr.get(attributes)
 
 
-def emit_benchmarking_function(name: str,
-                               func: builtin.FuncOp) -> builtin.FuncOp:
+def emit_benchmarking_function(
+    name: str,
+    func: builtin.FuncOp,
+    record_iteration_durations: bool = False) -> builtin.FuncOp:
   """Produces the benchmarking function.
 
   This function calls the given function `func` as many times as requested by
-  its last argument.
+  its index argument, which follows the arguments of `func`, and returns the
+  total time in nanoseconds.
+
+  With `record_iteration_durations`, the function takes a last `memref<?xi64>`
+  argument, with at least as many elements as iterations, and also stores the
+  time in nanoseconds of every iteration into it.
   """
   i64_type = IntegerType.get_signless(64)
   nano_time = builtin.FuncOp(
       "nano_time", ([], [i64_type]), visibility="private")
   nano_time.attributes["llvm.emit_c_interface"] = UnitAttr.get()
 
+  extra_arg_types = [IndexType.get()]
+  if record_iteration_durations:
+    extra_arg_types.append(MemRefType.get([-1], i64_type))
   wrapper = builtin.FuncOp(
-      name, (func.arguments.types + [IndexType.get()],
+      name, (func.arguments.types + extra_arg_types,
              func.type.results + [i64_type]),
       visibility="public")
   wrapper.attributes["llvm.emit_c_interface"] = UnitAttr.get()
-  wrapper.arg_attrs = func.arg_attrs + [DictAttr.get()]
+  wrapper.arg_attrs = func.arg_attrs + [DictAttr.get()] * len(extra_arg_types)
 
   num_results = len(func.type.results)
+  num_func_args = len(func.arguments.types)
   with InsertionPoint(wrapper.add_entry_block()):
+    func_args = list(wrapper.arguments)[:num_func_args]
+    n_iters = wrapper.arguments[num_func_args]
     zero = arith.ConstantOp.create_index(0)
     one = arith.ConstantOp.create_index(1)
     total_time = arith.ConstantOp(i64_type, 0)
-    iter_args = list(wrapper.arguments[-num_results - 1:-1])
+    iter_args = func_args[num_func_args - num_results:]
     iter_args.append(total_time.result)
-    loop = scf.ForOp(zero, wrapper.arguments[-1], one, iter_args)
+    loop = scf.ForOp(zero, n_iters, one, iter_args)
     with InsertionPoint(loop.body):
       time_accumulator = loop.inner_iter_args[-1]
       start = std.CallOp(nano_time, [])
       call = std.CallOp(
-          func,
-          wrapper.arguments[:-num_results - 1] + loop.inner_iter_args[:-1])
+          func, func_args[:num_func_args - num_results] +
+          list(loop.inner_iter_args[:-1]))
       end = std.CallOp(nano_time, [])
       time = arith.SubIOp(end, start)
+      if record_iteration_durations:
+        memref.StoreOp(time, wrapper.arguments[num_func_args + 1],
+                       [loop.induction_variable])
       partial_time = arith.AddIOp(time_accumulator, time)
       scf.YieldOp(list(call.results) + [partial_time.result])
     std.ReturnOp(loop)
@@ -202,17 +210,31 @@ def compile_and_callback(op, transform: Callable, callback: Callable,
 
 # JIT compile and return an execution engine that can be invoked.
 # Needs to be run under Context.
-def compile_to_execution_engine(module,
-                                transform: Callable,
-                                opt_level: int = 3):
+# If `compile_timings` is given, it receives the compile time breakdown. Passing
+# `entry_point_name` then also forces code generation, which the execution
+# engine otherwise defers to the first invocation.
+def compile_to_execution_engine(
+    module,
+    transform: Callable,
+    opt_level: int = 3,
+    entry_point_name: Optional[str] = None,
+    compile_timings: Optional[CompileTimings] = None):
+  timings = CompileTimings() if compile_timings is None else compile_timings
   start = time.time()
-  transformed_module = transform(module)
+  with timings.activate():
+    transformed_module = transform(module)
+  translation_start = time.time()
   execution_engine = ExecutionEngine(
       transformed_module,
       opt_level,
       shared_libs=[
           os.getenv(_MLIR_RUNNER_UTILS_LIB_ENV, _MLIR_RUNNER_UTILS_LIB_DEFAULT)
       ])
+  timings.llvm_translation_and_optimization_s = time.time() - translation_start
+  if compile_timings is not None and entry_point_name is not None:
+    codegen_start = time.time()
+    execution_engine.lookup(entry_point_name)
+    timings.llvm_codegen_s = time.time() - codegen_start
   elapsed_compilation_s = time.time() - start
   print(f"compilation in {elapsed_compilation_s:.{4}}s")
   return transformed_module, execution_engine
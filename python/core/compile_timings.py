@@ -0,0 +1,75 @@
+# pytype: skip-file
+
+import contextlib
+import json
+import threading
+import time
+
+from typing import Optional
+
+_active = threading.local()
+
+
+class CompileTimings:
+  """Wall-clock compile time breakdown of one compilation, in seconds.
+
+  Mirrors the stages of ModelRunner's CompileTimings. MLIR is timed per
+  transform rather than per pass, as the Python bindings do not expose pass
+  instrumentation. The ExecutionEngine translates to LLVM IR and optimizes it
+  on creation, so these two stages are timed together. Code generation happens
+  on the first lookup and is only timed when the compilation forces it.
+  """
+
+  def __init__(self):
+    self.mlir_transforms = []
+    self.llvm_translation_and_optimization_s = 0.0
+    self.llvm_codegen_s = 0.0
+
+  @property
+  def mlir_transforms_s(self) -> float:
+    return sum(t['seconds'] for t in self.mlir_transforms)
+
+  @property
+  def total_s(self) -> float:
+    return (self.mlir_transforms_s + self.llvm_translation_and_optimization_s +
+            self.llvm_codegen_s)
+
+  @contextlib.contextmanager
+  def activate(self):
+    """Make this the target of `time_transform` on the calling thread."""
+    previous = getattr(_active, 'timings', None)
+    _active.timings = self
+    try:
+      yield self
+    finally:
+      _active.timings = previous
+
+  def to_json(self) -> str:
+    return json.dumps({
+        'mlir_transforms_s': self.mlir_transforms_s,
+        'mlir_transforms': self.mlir_transforms,
+        'llvm_translation_and_optimization_s':
+            self.llvm_translation_and_optimization_s,
+        'llvm_codegen_s': self.llvm_codegen_s,
+        'total_s': self.total_s,
+    })
+
+
+def active_compile_timings() -> Optional[CompileTimings]:
+  return getattr(_active, 'timings', None)
+
+
+@contextlib.contextmanager
+def time_transform(transform):
+  """Record the time of `transform` in the active CompileTimings, if any."""
+  timings = active_compile_timings()
+  start = time.time()
+  try:
+    yield
+  finally:
+    if timings is not None:
+      entry = {'name': type(transform).__name__}
+      if hasattr(transform, 'pipeline'):
+        entry['pipeline'] = transform.pipeline
+      entry['seconds'] = time.time() - start
+      timings.mlir_transforms.append(entry)
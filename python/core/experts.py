@@ -2,6 +2,7 @@ from typing import Any, List, NewType, Optional, Sequence, Type
 
 from mlir.ir import *
 
+from .compile_timings import time_transform
 from .search_vars import *
 from .transforms import *
 
@@ -37,7 +38,8 @@ class TransformationList:
 
       if print_ir:
         print('[[[ IR after transform: ' + str(transform) + ']]]')
-      module = transform(module, entry_point_name)
+      with time_transform(transform):
+        module = transform(module, entry_point_name)
       if print_ir:
         print(module)
     return module
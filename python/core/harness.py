@@ -1,3 +1,6 @@
+import contextlib
+import math
+import statistics
 import sys
 
 from collections.abc import Callable
@@ -11,6 +14,8 @@ from mlir.runtime import *
 
 from ..core.compilation import compile_to_execution_engine, \
     emit_benchmarking_function
+from ..core.compile_timings import CompileTimings
+from ..core.perf_counters import PerfCounters
 from ..core.problem_definition import *
 from ..core.utils import *
 
@@ -22,9 +27,17 @@ def log(*args):
   sys.stderr.flush()
 
 
-def timed_invoke(run_n_iters: Callable, gflop_count: float, gbyte_count: float,
-                 n_iters: int):
-  elapsed_ns = run_n_iters(n_iters)
+def timed_invoke(run_n_iters: Callable,
+                 gflop_count: float,
+                 gbyte_count: float,
+                 n_iters: int,
+                 perf_counters: Optional[PerfCounters] = None):
+  if perf_counters is not None:
+    perf_counters.reset()
+    with perf_counters:
+      elapsed_ns = run_n_iters(n_iters)
+  else:
+    elapsed_ns = run_n_iters(n_iters)
   elapsed_s = elapsed_ns / 1.e9
   elapsed_s_per_iter = elapsed_s / n_iters
   gflop_per_s_per_iter = gflop_count / (elapsed_s_per_iter)
@@ -34,6 +47,140 @@ def timed_invoke(run_n_iters: Callable, gflop_count: float, gbyte_count: float,
         f"sec ({gflop_per_s_per_iter:.{4}} GFlop/s, "
         f"{gbyte_per_s_per_iter:.{4}} GB/s) "
         f"total time {elapsed_s:.{4}}s ")
+  if perf_counters is not None:
+    print(f"xxxxxxxxxx : {perf_counters.report(n_iters)}")
+
+
+def count_warmup_samples(samples: Sequence[float],
+                         threshold: float = 3.,
+                         min_relative_deviation: float = 0.01) -> int:
+  """Return the number of leading samples that are slower than steady state.
+
+  The steady state is estimated from the second half of the samples. Leading
+  samples more than `threshold` scaled median absolute deviations above its
+  median are warm-up. The deviation is at least `min_relative_deviation` of
+  the median, such that a steady state with (nearly) identical samples does not
+  turn any slower sample into warm-up. At least half of the samples, and at
+  least 2 so that the confidence interval of the mean is finite, are always
+  kept.
+  """
+  tail = np.array(samples[len(samples) // 2:])
+  median = np.median(tail)
+  deviation = max(np.median(np.abs(tail - median)),
+                  min_relative_deviation * median)
+  limit = median + threshold * 1.4826 * deviation
+  max_warmup = min(len(samples) // 2, len(samples) - 2)
+  n_warmup = 0
+  while n_warmup < max_warmup and samples[n_warmup] > limit:
+    n_warmup += 1
+  return n_warmup
+
+
+class TimingStatistics:
+  """Statistics of per-repetition samples of the time per iteration.
+
+  The first `n_warmup` samples are discarded. The confidence interval of the
+  mean uses the normal approximation.
+  """
+
+  def __init__(self, samples_s: Sequence[float], n_warmup: int,
+               confidence: float):
+    self.samples_s = list(samples_s)
+    self.n_warmup = n_warmup
+    self.confidence = confidence
+    steady = np.array(self.samples_s[n_warmup:])
+    self.median_s = float(np.median(steady))
+    self.p10_s, self.p90_s = (float(p) for p in np.percentile(steady, [10, 90]))
+    self.mean_s = float(np.mean(steady))
+    self.stddev_s = float(np.std(steady, ddof=1)) if len(steady) > 1 else 0.
+    z = statistics.NormalDist().inv_cdf((1. + confidence) / 2.)
+    self.ci_half_width_s = z * self.stddev_s / math.sqrt(len(steady))
+
+  @property
+  def relative_error(self) -> float:
+    """Half width of the confidence interval relative to the mean."""
+    if len(self.samples_s) - self.n_warmup < 2 or self.mean_s == 0.:
+      return math.inf
+    return self.ci_half_width_s / self.mean_s
+
+
+def statistical_timed_invoke(run_n_iters: Callable,
+                             gflop_count: float,
+                             gbyte_count: float,
+                             n_iters: int,
+                             n_repetitions: int,
+                             target_relative_error: Optional[float] = None,
+                             max_repetitions: int = 100,
+                             confidence: float = 0.95,
+                             perf_counters: Optional[PerfCounters] = None
+                            ) -> TimingStatistics:
+  """Time `n_repetitions` runs of `n_iters` iterations each.
+
+  If `target_relative_error` is set, keep adding batches of `n_repetitions`
+  until the confidence interval of the mean is within that relative error of
+  the mean, or until `max_repetitions`.
+  """
+  samples_s = []
+  counting = perf_counters if perf_counters is not None else \
+      contextlib.nullcontext()
+
+  def run_repetitions(n: int):
+    with counting:
+      for _ in range(n):
+        samples_s.append(run_n_iters(n_iters) / 1.e9 / n_iters)
+
+  if perf_counters is not None:
+    perf_counters.reset()
+  run_repetitions(n_repetitions)
+  while True:
+    stats = TimingStatistics(samples_s, count_warmup_samples(samples_s),
+                             confidence)
+    if target_relative_error is None or \
+        stats.relative_error <= target_relative_error or \
+        len(samples_s) >= max_repetitions:
+      break
+    run_repetitions(min(n_repetitions, max_repetitions - len(samples_s)))
+
+  median_s = stats.median_s
+  print(f"xxxxxxxxxx : {len(samples_s)} reps "
+        f"({stats.n_warmup} warm-up discarded) of {n_iters} iters "
+        f"on {1} threads in {median_s:.{4}}s per iter median "
+        f"({gflop_count / median_s:.{4}} GFlop/s, "
+        f"{gbyte_count / median_s:.{4}} GB/s) "
+        f"p10 {stats.p10_s:.{4}}s p90 {stats.p90_s:.{4}}s "
+        f"stddev {stats.stddev_s:.{4}}s "
+        f"{confidence:.0%} CI +-{stats.relative_error:.2%}")
+  if target_relative_error is not None and \
+      stats.relative_error > target_relative_error:
+    print(f"xxxxxxxxxx : target relative error {target_relative_error:.2%} "
+          f"not reached in {max_repetitions} reps")
+  if perf_counters is not None:
+    print(f"xxxxxxxxxx : "
+          f"{perf_counters.report(n_iters * len(samples_s))}")
+  return stats
+
+
+def print_latency_histogram(durations_ns: Sequence[int], n_bins: int = 10):
+  """Print the tail percentiles and a histogram of per-iteration durations.
+
+  Bins are log-spaced so that rare stalls remain visible next to the bulk of
+  the iterations.
+  """
+  durations_s = np.asarray(durations_ns) / 1.e9
+  percentiles = [50, 90, 99, 99.9]
+  values = np.percentile(durations_s, percentiles)
+  print(f"xxxxxxxxxx : {len(durations_s)} iters latency " +
+        " ".join(f"p{p:g} {v:.{4}}s" for p, v in zip(percentiles, values)) +
+        f" max {durations_s.max():.{4}}s")
+  low, high = durations_s.min(), durations_s.max()
+  if low == high:
+    return
+  bins = np.geomspace(low, high, n_bins + 1) if low > 0. else n_bins
+  counts, edges = np.histogram(durations_s, bins=bins)
+  for count, start, end in zip(counts, edges[:-1], edges[1:]):
+    # Keep single outliers visible.
+    bar = "#" * int(np.ceil(50 * count / counts.max()))
+    print(f"xxxxxxxxxx : [{start:.{4}}s, {end:.{4}}s] {count:>8} {bar}")
 
 
 # TODO: support more than just RankedTensorType.
@@ -82,6 +229,8 @@ class ProblemInstance:
     self.mlir_context = None
     self.mlir_module = None
     self.mlir_execution_engine = None
+    self.compile_timings = None
+    self.record_iteration_durations = False
 
   def compile(
       self,
@@ -90,13 +239,16 @@ class ProblemInstance:
       compile_time_problem_sizes_dict: dict,
       # TODO: Better type than Callable.
       transform: Callable,
-      dump_ir_to_file: str = ""):
+      dump_ir_to_file: str = "",
+      print_compile_timings: bool = False,
+      record_iteration_durations: bool = False):
     assert self.compile_time_problem_sizes_dict is None, \
         f"Problem already compiled, please instantiate a new problem"
     assert_dict_entries_match_keys(compile_time_problem_sizes_dict,
                                    self.problem_sizes_keys)
 
     self.compile_time_problem_sizes_dict = compile_time_problem_sizes_dict
+    self.record_iteration_durations = record_iteration_durations
 
     with Context() as ctx, Location.unknown() as loc:
       self.mlir_context = ctx
@@ -112,13 +264,20 @@ class ProblemInstance:
 
         func = self.problem_definition.build_problem_under_context_manager(
             fun_to_benchmark_name, *types)
-        wrapper = emit_benchmarking_function(entry_point_name, func)
+        wrapper = emit_benchmarking_function(entry_point_name, func,
+                                             record_iteration_durations)
 
       def apply_transform_to_entry_point_name(module):
         return transform(entry_point_name, module)
 
+      self.compile_timings = CompileTimings()
       transformed_module, self.mlir_execution_engine = compile_to_execution_engine(
-          self.mlir_module, apply_transform_to_entry_point_name)
+          self.mlir_module,
+          apply_transform_to_entry_point_name,
+          entry_point_name=entry_point_name,
+          compile_timings=self.compile_timings)
+      if print_compile_timings:
+        print(self.compile_timings.to_json())
 
       if (len(dump_ir_to_file) > 0):
         f = open(dump_ir_to_file, "w")
@@ -129,7 +288,20 @@ class ProblemInstance:
           n_iters: int,
           entry_point_name: str,
           runtime_problem_sizes_dict: dict,
-          dump_obj_to_file: str = ""):
+          dump_obj_to_file: str = "",
+          perf_counters: bool = False,
+          n_repetitions: int = 1,
+          target_relative_error: Optional[float] = None,
+          max_repetitions: int = 100) -> Optional[TimingStatistics]:
+    """Run `n_iters` iterations and print the time per iteration.
+
+    With `n_repetitions` > 1 or a `target_relative_error`, time repeated runs of
+    `n_iters` iterations instead, discard the warm-up runs and return the
+    statistics of the remaining ones. See `statistical_timed_invoke`.
+
+    If the problem was compiled with `record_iteration_durations`, also print
+    the latency histogram of all the timed iterations.
+    """
     assert_dict_entries_match_keys(runtime_problem_sizes_dict,
                                    self.problem_sizes_keys)
     assert_runtime_sizes_compatible_with_compile_time_sizes(
@@ -147,13 +319,21 @@ class ProblemInstance:
         np_input_and_outputs)
 
     # 2. Setup function to run, taking just an n_iters arg.
+    iteration_durations_args = []
+    iteration_durations_ns = []
+    if self.record_iteration_durations:
+      durations = np.zeros(max(n_iters, 1), dtype=np.int64)
+      iteration_durations_args = get_mlir_abi_compatible_types([durations])
+
     def run_n_iters(n_iters: int):
       index_ptr_t = ctypes.c_longlong * 1
       execution_time_data = index_ptr_t()
       self.mlir_execution_engine.invoke(
           entry_point_name, *mlir_input_and_outputs_pointers,
-          index_ptr_t(n_iters),
+          index_ptr_t(n_iters), *iteration_durations_args,
           ctypes.cast(execution_time_data, ctypes.POINTER(index_ptr_t)))
+      if self.record_iteration_durations:
+        iteration_durations_ns.append(durations[:n_iters].copy())
       return execution_time_data[0]
 
     # 3. Dry-run.
@@ -170,11 +350,29 @@ class ProblemInstance:
       run_n_iters(1)
 
     # 5. Showtime.
-    timed_invoke(
-        run_n_iters=run_n_iters,
-        gflop_count=self.problem_definition.gflop_count_builder(*list_of_sizes),
-        gbyte_count=self.problem_definition.gbyte_count_builder(
-            *list_of_sizes, *self.np_types),
-        n_iters=n_iters)
-
-    return
+    iteration_durations_ns.clear()
+    gflop_count = self.problem_definition.gflop_count_builder(*list_of_sizes)
+    gbyte_count = self.problem_definition.gbyte_count_builder(
+        *list_of_sizes, *self.np_types)
+    stats = None
+    if n_repetitions > 1 or target_relative_error is not None:
+      stats = statistical_timed_invoke(
+          run_n_iters=run_n_iters,
+          gflop_count=gflop_count,
+          gbyte_count=gbyte_count,
+          n_iters=n_iters,
+          n_repetitions=max(n_repetitions, 2),
+          target_relative_error=target_relative_error,
+          max_repetitions=max_repetitions,
+          perf_counters=PerfCounters() if perf_counters else None)
+    else:
+      timed_invoke(
+          run_n_iters=run_n_iters,
+          gflop_count=gflop_count,
+          gbyte_count=gbyte_count,
+          n_iters=n_iters,
+          perf_counters=PerfCounters() if perf_counters else None)
+
+    if self.record_iteration_durations:
+      print_latency_histogram(np.concatenate(iteration_durations_ns))
+    return stats
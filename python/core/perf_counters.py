@@ -0,0 +1,144 @@
+# pytype: skip-file
+
+import ctypes
+import os
+import platform
+import struct
+
+from typing import Dict
+
+# perf_event_open syscall numbers.
+_PERF_EVENT_OPEN_SYSCALL = {'x86_64': 298, 'aarch64': 241}
+
+# From linux/perf_event.h.
+_PERF_TYPE_HARDWARE = 0
+_PERF_TYPE_HW_CACHE = 3
+_PERF_TYPE_RAW = 4
+_PERF_COUNT_HW_CPU_CYCLES = 0
+_PERF_COUNT_HW_INSTRUCTIONS = 1
+_PERF_COUNT_HW_CACHE_MISSES = 3
+_PERF_COUNT_HW_CACHE_L1D = 0
+_PERF_COUNT_HW_CACHE_OP_READ = 0
+_PERF_COUNT_HW_CACHE_RESULT_MISS = 1
+_PERF_FORMAT_TOTAL_TIME_ENABLED = 1 << 0
+_PERF_FORMAT_TOTAL_TIME_RUNNING = 1 << 1
+_PERF_EVENT_IOC_ENABLE = 0x2400
+_PERF_EVENT_IOC_DISABLE = 0x2401
+_PERF_EVENT_IOC_RESET = 0x2403
+# Bits of the perf_event_attr flags.
+_DISABLED = 1 << 0
+_EXCLUDE_KERNEL = 1 << 5
+_EXCLUDE_HV = 1 << 6
+
+
+class _PerfEventAttr(ctypes.Structure):
+  # PERF_ATTR_SIZE_VER5 layout; the bitfields are folded into `flags`.
+  _fields_ = [
+      ('type', ctypes.c_uint32),
+      ('size', ctypes.c_uint32),
+      ('config', ctypes.c_uint64),
+      ('sample_period', ctypes.c_uint64),
+      ('sample_type', ctypes.c_uint64),
+      ('read_format', ctypes.c_uint64),
+      ('flags', ctypes.c_uint64),
+      ('wakeup_events', ctypes.c_uint32),
+      ('bp_type', ctypes.c_uint32),
+      ('config1', ctypes.c_uint64),
+      ('config2', ctypes.c_uint64),
+      ('branch_sample_type', ctypes.c_uint64),
+      ('sample_regs_user', ctypes.c_uint64),
+      ('sample_stack_user', ctypes.c_uint32),
+      ('clockid', ctypes.c_int32),
+      ('sample_regs_intr', ctypes.c_uint64),
+      ('aux_watermark', ctypes.c_uint32),
+      ('sample_max_stack', ctypes.c_uint16),
+      ('reserved_2', ctypes.c_uint16),
+  ]
+
+
+def _is_intel() -> bool:
+  try:
+    with open('/proc/cpuinfo') as f:
+      return any('GenuineIntel' in line for line in f
+                 if line.startswith('vendor_id'))
+  except OSError:
+    return False
+
+
+def _event_configs() -> Dict[str, tuple]:
+  cache_miss = lambda cache: cache | (_PERF_COUNT_HW_CACHE_OP_READ << 8) | (
+      _PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+  configs = {
+      'cycles': (_PERF_TYPE_HARDWARE, _PERF_COUNT_HW_CPU_CYCLES),
+      'instructions': (_PERF_TYPE_HARDWARE, _PERF_COUNT_HW_INSTRUCTIONS),
+      'l1d_read_misses':
+          (_PERF_TYPE_HW_CACHE, cache_miss(_PERF_COUNT_HW_CACHE_L1D)),
+      'llc_misses': (_PERF_TYPE_HARDWARE, _PERF_COUNT_HW_CACHE_MISSES),
+  }
+  # FP_ARITH_INST_RETIRED with all scalar and packed umasks set, available
+  # since Broadwell. There is no generic perf event for FP operations.
+  if platform.machine() == 'x86_64' and _is_intel():
+    configs['fp_arith_instructions'] = (_PERF_TYPE_RAW, 0xffc7)
+  return configs
+
+
+class PerfCounters:
+  """Hardware performance counters of the calling thread.
+
+  Counts accumulate while the object is used as a context manager, until
+  `reset`. Counters that the kernel or CPU do not provide, e.g. because of
+  `perf_event_paranoid` or inside VMs, are silently skipped.
+  """
+
+  def __init__(self):
+    self.fds = {}
+    syscall = _PERF_EVENT_OPEN_SYSCALL.get(platform.machine())
+    if syscall is None:
+      return
+    libc = ctypes.CDLL(None, use_errno=True)
+    self._ioctl = libc.ioctl
+    for name, (type, config) in _event_configs().items():
+      attr = _PerfEventAttr()
+      attr.type = type
+      attr.size = ctypes.sizeof(_PerfEventAttr)
+      attr.config = config
+      attr.flags = _DISABLED | _EXCLUDE_KERNEL | _EXCLUDE_HV
+      attr.read_format = (
+          _PERF_FORMAT_TOTAL_TIME_ENABLED | _PERF_FORMAT_TOTAL_TIME_RUNNING)
+      fd = libc.syscall(syscall, ctypes.byref(attr), 0, -1, -1, 0)
+      if fd >= 0:
+        self.fds[name] = fd
+
+  def __del__(self):
+    for fd in self.fds.values():
+      os.close(fd)
+
+  def __enter__(self):
+    for fd in self.fds.values():
+      self._ioctl(fd, _PERF_EVENT_IOC_ENABLE, 0)
+    return self
+
+  def __exit__(self, *args):
+    for fd in self.fds.values():
+      self._ioctl(fd, _PERF_EVENT_IOC_DISABLE, 0)
+
+  def reset(self):
+    for fd in self.fds.values():
+      self._ioctl(fd, _PERF_EVENT_IOC_RESET, 0)
+
+  def read(self) -> Dict[str, int]:
+    """Return the counts, scaled up when the kernel multiplexed counters."""
+    counts = {}
+    for name, fd in self.fds.items():
+      value, enabled, running = struct.unpack('QQQ', os.read(fd, 24))
+      counts[name] = value * enabled // running if running else 0
+    return counts
+
+  def report(self, n_iters: int) -> str:
+    counts = self.read()
+    if not counts:
+      return 'perf counters unavailable'
+    fields = [f'{counts[name] / n_iters:.{4}} {name}' for name in counts]
+    if counts.get('cycles') and 'instructions' in counts:
+      fields.append(f'{counts["instructions"] / counts["cycles"]:.{3}} IPC')
+    return 'per iter: ' + ', '.join(fields)
@@ -0,0 +1,131 @@
+# pytype: skip-file
+
+import functools
+import os
+import platform
+
+from typing import FrozenSet, List, Optional, Tuple
+
+# Sets the `target-cpu`, e.g. to compile for a specific machine of the fleet.
+# Features are then derived from the CPU name by LLVM instead of the host.
+_TARGET_CPU_ENV = 'SANDBOX_TARGET_CPU'
+
+# Map from /proc/cpuinfo flags to the LLVM target features we care about.
+_X86_CPUINFO_FLAGS_TO_FEATURES = {
+    'avx': 'avx',
+    'avx2': 'avx2',
+    'fma': 'fma',
+    'f16c': 'f16c',
+    'bmi2': 'bmi2',
+    'adx': 'adx',
+    'avx512f': 'avx512f',
+    'avx512cd': 'avx512cd',
+    'avx512bw': 'avx512bw',
+    'avx512dq': 'avx512dq',
+    'avx512vl': 'avx512vl',
+    'avx512_vnni': 'avx512vnni',
+    'avx512_bf16': 'avx512bf16',
+    'amx_tile': 'amx-tile',
+    'amx_int8': 'amx-int8',
+    'amx_bf16': 'amx-bf16',
+}
+
+_AVX512_FEATURES = {'avx512f', 'avx512cd', 'avx512bw', 'avx512dq', 'avx512vl'}
+
+class HostTarget:
+  """Vector features of the machine the benchmarks run on.
+
+  `cpu` is only set when overridden with SANDBOX_TARGET_CPU: the features are
+  then derived from the CPU name by LLVM and `features` is empty. Otherwise the
+  features detected on the host are passed to LLVM without a CPU name, which
+  /proc/cpuinfo does not reliably provide.
+  """
+
+  def __init__(self, cpu: Optional[str], features: FrozenSet[str]):
+    self.cpu = cpu
+    self.features = features
+
+  @property
+  def has_avx2(self) -> bool:
+    return 'avx2' in self.features
+
+  @property
+  def has_avx512(self) -> bool:
+    return 'avx512f' in self.features
+
+  @property
+  def has_vnni(self) -> bool:
+    return 'avx512vnni' in self.features
+
+  @property
+  def has_bf16(self) -> bool:
+    return 'avx512bf16' in self.features
+
+  @property
+  def has_amx(self) -> bool:
+    return 'amx-tile' in self.features
+
+  @property
+  def vector_width(self) -> int:
+    """Widest native vector width in bits."""
+    if self.has_avx512:
+      return 512
+    if 'avx' in self.features:
+      return 256
+    return 128
+
+  def passthrough(self, avx512: bool = True) -> List[Tuple[str, str]]:
+    """Return the (key, value) LLVM function attributes for this target.
+
+    `avx512` selects the preferred vector width when the host has AVX-512;
+    it is ignored otherwise.
+    """
+    attributes = []
+    if self.cpu is not None:
+      attributes.append(('target-cpu', self.cpu))
+    if self.features:
+      features = ','.join('+' + f for f in sorted(self.features))
+      attributes.append(('target-features', features))
+      width = self.vector_width
+      if width == 512 and not avx512:
+        width = 256
+      attributes.append(('prefer-vector-width', str(width)))
+    elif self.cpu is not None:
+      # The features of the CPU are unknown here, LLVM clamps the preferred
+      # width to the widest legal vectors of the CPU.
+      attributes.append(('prefer-vector-width', '512' if avx512 else '256'))
+    elif not avx512:
+      attributes.append(('prefer-vector-width', '256'))
+    return attributes
+
+  def __str__(self):
+    return f'HostTarget(cpu={self.cpu}, features={sorted(self.features)})'
+
+
+def _read_x86_cpuinfo_features() -> FrozenSet[str]:
+  try:
+    with open('/proc/cpuinfo') as f:
+      for line in f:
+        if line.startswith('flags'):
+          flags = line.split(':', 1)[1].split()
+          return frozenset(_X86_CPUINFO_FLAGS_TO_FEATURES[flag]
+                           for flag in flags
+                           if flag in _X86_CPUINFO_FLAGS_TO_FEATURES)
+  except OSError:
+    pass
+  return frozenset()
+
+
+@functools.lru_cache(maxsize=None)
+def host_target() -> HostTarget:
+  """Detect the host target once per process.
+
+  Only the features of x86 hosts are detected; other hosts rely on the JIT
+  targeting the host.
+  """
+  cpu = os.getenv(_TARGET_CPU_ENV)
+  if cpu is not None:
+    return HostTarget(cpu, frozenset())
+  if platform.machine() not in ('x86_64', 'AMD64'):
+    return HostTarget(None, frozenset())
+  return HostTarget(None, _read_x86_cpuinfo_features())
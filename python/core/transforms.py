@@ -3,6 +3,8 @@ from mlir.passmanager import *
 
 import mlir.all_passes_registration
 
+from .target import host_target
+
 
 class Transform:
   """Base class for all parametrized transformations."""
@@ -266,8 +268,15 @@ class LowerVectors(Transform):
 class LowerToLLVM(Transform):
 
   def __init__(self, **kwargs):
+    target = host_target()
+    enable_x86vector = target.has_avx2 if 'enable_x86vector' not in kwargs \
+        else kwargs['enable_x86vector']
+    enable_amx = target.has_amx if 'enable_amx' not in kwargs \
+        else kwargs['enable_amx']
     pipeline = (f'linalg-tensor-codegen-driver{{'
-                f'    lower-to-llvm}},'
+                f'    lower-to-llvm '
+                f'    enable-x86vector={enable_x86vector} '
+                f'    enable-amx={enable_amx}}},'
                 f'canonicalize,'
                 f'cse')
     self.pipeline = pipeline
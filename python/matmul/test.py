@@ -232,6 +232,67 @@ def main():
             entry_point_name='matmul_main',
             runtime_problem_sizes_dict=runtime_problem_sizes_dict)
 
+  # Statistical runs. With 2 repetitions, both are kept to bound the
+  # confidence interval.
+  problem_sizes_dict = {k: v for k, v in zip(keys, problem_size_list[0])}
+  problem = ProblemInstance(
+      problem_definition=MatmulProblem(),
+      problem_sizes_keys=keys,
+      np_types=[np.float32, np.float32, np.float32])
+  problem.compile(
+      entry_point_name='matmul_main',
+      fun_to_benchmark_name='matmul_on_tensors',
+      compile_time_problem_sizes_dict=problem_sizes_dict,
+      transform=expert_tile_1)
+  # CHECK: 2 reps (0 warm-up discarded) of 10 iters
+  # CHECK-NOT: inf
+  problem.run(
+      n_iters=10,
+      entry_point_name='matmul_main',
+      runtime_problem_sizes_dict=problem_sizes_dict,
+      n_repetitions=2)
+
+  # A slow first repetition is discarded as warm-up.
+  # CHECK: 6 reps (1 warm-up discarded) of 1 iters
+  # CHECK-SAME: 95% CI +-{{[0-9.]+}}%
+  durations_ns = iter([50., 10., 11., 10., 9., 10.])
+  statistical_timed_invoke(
+      run_n_iters=lambda n_iters: next(durations_ns),
+      gflop_count=1.,
+      gbyte_count=1.,
+      n_iters=1,
+      n_repetitions=6)
+
+  # Noise within the minimal deviation is not warm-up, even when the steady
+  # samples are identical.
+  # CHECK: 6 reps (0 warm-up discarded) of 1 iters
+  durations_ns = iter([10.1, 10., 10., 10., 10., 10.])
+  statistical_timed_invoke(
+      run_n_iters=lambda n_iters: next(durations_ns),
+      gflop_count=1.,
+      gbyte_count=1.,
+      n_iters=1,
+      n_repetitions=6)
+
+  # Repeated runs recording the duration of every iteration.
+  problem = ProblemInstance(
+      problem_definition=MatmulProblem(),
+      problem_sizes_keys=keys,
+      np_types=[np.float32, np.float32, np.float32])
+  problem.compile(
+      entry_point_name='matmul_main',
+      fun_to_benchmark_name='matmul_on_tensors',
+      compile_time_problem_sizes_dict=problem_sizes_dict,
+      transform=expert_tile_1,
+      record_iteration_durations=True)
+  # CHECK: 3 reps ({{[0-9]+}} warm-up discarded) of 10 iters
+  # CHECK: 30 iters latency p50
+  problem.run(
+      n_iters=10,
+      entry_point_name='matmul_main',
+      runtime_problem_sizes_dict=problem_sizes_dict,
+      n_repetitions=3)
+
 
 if __name__ == '__main__':
   main()
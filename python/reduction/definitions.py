@@ -33,6 +33,85 @@ def column_reduction_2d(
   B[D.m] += A[D.m, D.n]
 
 
+################################################################################
+### N-D reductions
+################################################################################
+# The ops below reduce a subset of the dimensions of their input. They are
+# named after the reduced dimensions, e.g. `reduction_3d_02` reduces dimensions
+# 0 and 2 of a 3-D input. The iteration domain always follows the input layout
+# such that the innermost loop iterates over the innermost input dimension.
+
+
+@linalg_structured_op
+def reduction_2d_0(A=TensorDef(T, S.M, S.N), B=TensorDef(T, S.N, output=True)):
+  domain(D.m, D.n)
+  B[D.n] += A[D.m, D.n]
+
+
+@linalg_structured_op
+def reduction_3d_0(
+    A=TensorDef(T, S.M, S.N, S.K), B=TensorDef(T, S.N, S.K, output=True)):
+  domain(D.m, D.n, D.k)
+  B[D.n, D.k] += A[D.m, D.n, D.k]
+
+
+@linalg_structured_op
+def reduction_3d_1(
+    A=TensorDef(T, S.M, S.N, S.K), B=TensorDef(T, S.M, S.K, output=True)):
+  domain(D.m, D.n, D.k)
+  B[D.m, D.k] += A[D.m, D.n, D.k]
+
+
+@linalg_structured_op
+def reduction_3d_2(
+    A=TensorDef(T, S.M, S.N, S.K), B=TensorDef(T, S.M, S.N, output=True)):
+  domain(D.m, D.n, D.k)
+  B[D.m, D.n] += A[D.m, D.n, D.k]
+
+
+@linalg_structured_op
+def reduction_3d_01(
+    A=TensorDef(T, S.M, S.N, S.K), B=TensorDef(T, S.K, output=True)):
+  domain(D.m, D.n, D.k)
+  B[D.k] += A[D.m, D.n, D.k]
+
+
+@linalg_structured_op
+def reduction_3d_02(
+    A=TensorDef(T, S.M, S.N, S.K), B=TensorDef(T, S.N, output=True)):
+  domain(D.m, D.n, D.k)
+  B[D.n] += A[D.m, D.n, D.k]
+
+
+@linalg_structured_op
+def reduction_3d_12(
+    A=TensorDef(T, S.M, S.N, S.K), B=TensorDef(T, S.M, output=True)):
+  domain(D.m, D.n, D.k)
+  B[D.m] += A[D.m, D.n, D.k]
+
+
+# Map (rank, reduction dimensions) to the OpDSL definition that implements it.
+# Note that `column_reduction_2d` reduces the innermost dimension.
+reduction_ops = {
+    (2, (0,)): reduction_2d_0,
+    (2, (1,)): column_reduction_2d,
+    (3, (0,)): reduction_3d_0,
+    (3, (1,)): reduction_3d_1,
+    (3, (2,)): reduction_3d_2,
+    (3, (0, 1)): reduction_3d_01,
+    (3, (0, 2)): reduction_3d_02,
+    (3, (1, 2)): reduction_3d_12,
+}
+
+
+def reduction_op(rank: int, reduction_dims: Sequence[int]) -> Callable:
+  """Return the OpDSL definition reducing `reduction_dims` of a rank-`rank`
+  input."""
+  key = (rank, tuple(sorted(reduction_dims)))
+  assert key in reduction_ops, f'unsupported reduction: {key}'
+  return reduction_ops[key]
+
+
 class Reduction2DProblem(ProblemDefinition):
   """ Problem definition for a single fill + reduction_2d problem."""
 
@@ -130,3 +209,118 @@ class Reduction2DProblem(ProblemDefinition):
       std.ReturnOp([result])
 
     return func
+
+
+class ReductionNDProblem(ProblemDefinition):
+  """ Problem definition for a single fill + n-dimensional reduction problem."""
+
+  def __init__(self, rank: int, reduction_dims: Sequence[int]):
+    """Creates a problem definition for an n-dimensional reduction.
+
+    The reduced dimensions are specified by the `reduction_dims` array with the
+    same format as `axis` in `numpy.sum`. The rank (n) of the reduction is the
+    rank of the input.
+    """
+    assert all(0 <= d < rank for d in reduction_dims), \
+          'Expected reduction dimensions to be in [0,1,..,N-1]'
+    assert 0 < len(set(reduction_dims)) < rank, \
+          'Expected at least one reduced and one non-reduced dimension'
+    self.__rank = rank
+    self.__reduction_dims = tuple(sorted(set(reduction_dims)))
+    self.__op_builder = reduction_op(rank, self.__reduction_dims)
+
+  def __partition_argument_list(self, items: List):
+    """Splits items into parts containing integers and non-integers.
+
+    The integers are expected to be the leading arguments in the item list.
+    """
+    return items[:self.__rank], items[self.__rank:]
+
+  def shapes_builder(self, *sizes: int) -> List[List[int]]:
+    """Shape builder function.
+
+       Given a list of integer dimensions, return the list of lists of shapes
+       of the FuncOp operands. The FuncOp is responsible for distinguishing
+       between input operands and results.
+    """
+    return [[*sizes], [
+        s for i, s in enumerate(sizes) if i not in self.__reduction_dims
+    ]]
+
+  def gflop_count_builder(self, *sizes: int) -> float:
+    """GFlop builder function.
+
+       Given a list of integer dimensions, return the number of GFlops computed.
+    """
+    return float(np.prod(sizes)) / float(1e9)
+
+  def gbyte_count_builder(self, *args) -> float:
+    """GByte builder function.
+
+       Given a list of integer dimensions followed by a list of data types,
+       return the number of GBytes read or written.
+    """
+    sizes, types = self.__partition_argument_list(args)
+    shapes = self.shapes_builder(*sizes)
+    return float(
+        sum(np.prod(s) * np.dtype(t).itemsize for s, t in zip(shapes, types))
+    ) / float(1e9)
+
+  def tensors_np_builder(self, *args) -> List[np.dtype]:
+    sizes, np_types = self.__partition_argument_list(args)
+    shapes = self.shapes_builder(*sizes)
+    tensors = [
+        realign(np.random.rand(*s).astype(t), byte_alignment=64)
+        for s, t in zip(shapes, np_types)
+    ]
+    tensors[len(tensors) - 1].fill(0.)
+    return tensors
+
+  def check_np(self, A: np.dtype, B: np.dtype) -> None:
+    """NP checking function.
+
+       Given a list of NP values, check the precomputed results matches those
+       of the expected reference implementation.
+    """
+    expected = np.sum(A, axis=self.__reduction_dims)
+    if not np.allclose(B, expected):
+      delta = B - expected
+      max_abs_delta = max(delta.max(), delta.min(), key=abs)
+      raise Exception(f'max_abs_delta: {max_abs_delta} -> FAILURE ')
+
+  def types_mlir_builder(self, *args) -> List[Type]:
+    """ MLIR types builder.
+
+        Given a list of integer dimensions followed by a list of MLIR element
+        types, return the list of MLIR types of the FuncOp operands.
+    """
+    sizes, types = self.__partition_argument_list(args)
+    shapes = self.shapes_builder(*sizes)
+    return [RankedTensorType.get(s, t) for s, t in zip(shapes, types)]
+
+  def build_problem_under_context_manager(self, name: str,
+                                          input_mlir_type: Type,
+                                          res_mlir_type: Type):
+    # TODO: -> FuncOp
+    """MLIR problem builder.
+
+       Given a flat list of MLIR types, build and return the MLIR FuncOp that
+       implements the desired computation on those types.
+    """
+    global avx512
+
+    # Actual benchmarked function called under entry_point_name.
+    func = builtin.FuncOp(name,
+                          ([input_mlir_type, res_mlir_type], [res_mlir_type]))
+    # TODO: need something much more flexible to add func argument attributes.
+    attach_inplaceable_attributes(func, inplaceable=[False, True])
+    attach_passthrough(func, [StringAttr.get('noinline')], avx512=avx512)
+
+    output_elem_type = res_mlir_type.element_type
+    with InsertionPoint(func.add_entry_block()):
+      zero = arith.ConstantOp(output_elem_type, 0.0)
+      tensor_zero = linalg.FillOp(output=func.arguments[1], value=zero)
+      result = self.__op_builder(func.arguments[0], outs=[tensor_zero])
+      std.ReturnOp([result])
+
+    return func
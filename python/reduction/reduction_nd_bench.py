@@ -0,0 +1,116 @@
+# RUN: %PYTHON %s 2>&1 | FileCheck %s
+
+# This file contains small benchmarks with reasonably-sized problem/tiling sizes
+# and codegen options for n-dimensional reductions.
+
+from ..core.experts import *
+from ..core.harness import *
+from ..core.transforms import *
+
+from .definitions import *
+
+fun_name = 'reduction_nd_on_tensors'
+op_name = 'linalg.generic'
+
+################################################################################
+### Compilation strategies.
+################################################################################
+
+
+def reduction_expert(rank: int,
+                     reduction_dims: Sequence[int],
+                     rows_per_vector: int = 4,
+                     vector_size: int = 64):
+  """Return an expert matching the reduced dimensions.
+
+  Inner reductions, i.e. reductions of the innermost dimension, tile the
+  innermost parallel dimension by `rows_per_vector` such that every vector
+  holds multiple rows. The resulting vector.multi_reduction is lowered with
+  `innerreduction`, i.e. one horizontal reduction tree per row. All other
+  reductions tile the innermost reduced dimension by `rows_per_vector` and are
+  lowered with `innerparallel`, i.e. elementwise vector accumulations.
+  """
+  inner_reduction = (rank - 1) in reduction_dims
+  parallel_dims = [d for d in range(rank) if d not in reduction_dims]
+  sizes = [1] * rank
+  sizes[-1] = vector_size
+  if inner_reduction:
+    sizes[parallel_dims[-1]] = rows_per_vector
+  else:
+    sizes[max(reduction_dims)] = rows_per_vector
+  return SingleTilingExpert(
+      fun_name=fun_name,
+      op_name=op_name,
+      sizes=sizes,
+      interchange=[],
+      peel=[],
+      pad=False,
+      pack_paddings=[],
+      hoist_paddings=[],
+      # kwargs passed down to LowerVectors.
+      # TODO: better composition of experts.
+      multi_reduction_lowering='innerreduction'
+      if inner_reduction else 'innerparallel',
+      print_ir_after_all=False)
+
+
+################################################################################
+### Problem instantiations.
+################################################################################
+
+keys = ['M', 'N', 'K']
+
+
+# CHECK-NOT: FAILURE
+def main():
+  n_iters = 100
+  # List of problems (sizes, reduction dimensions, rows per vector).
+  problem_list = [
+      # Row reductions.
+      ([1000, 1024], [1], 4),
+      ([8000, 6144], [1], 8),
+      ([64, 128, 1024], [2], 8),
+      ([64, 128, 1024], [1, 2], 4),
+      # Column and mixed reductions.
+      ([1000, 1024], [0], 4),
+      ([64, 128, 1024], [0, 1], 4),
+      ([64, 128, 1024], [0, 2], 4),
+  ]
+  for np_types in [[np.float32, np.float32]]:
+    for sizes, reduction_dims, rows_per_vector in problem_list:
+      rank = len(sizes)
+      problem_keys = keys[:rank]
+      compile_time_problem_sizes_dict = {
+          k: v for k, v in zip(problem_keys, sizes)
+      }
+      runtime_problem_sizes_dict = compile_time_problem_sizes_dict
+      # Init printing.
+      print(f'\n#############################################################\n'
+            f'Compile-time problem sizes {compile_time_problem_sizes_dict}\n'
+            f'Runtime problem sizes {runtime_problem_sizes_dict}\n'
+            f'Reduction dimensions {reduction_dims}\n'
+            f'Problem types {np_types}')
+
+      expert = reduction_expert(
+          rank, reduction_dims, rows_per_vector=rows_per_vector)
+      print(f'\nCompilation expert {expert}')
+
+      problem = ProblemInstance(
+          problem_definition=ReductionNDProblem(rank, reduction_dims),
+          problem_sizes_keys=problem_keys,
+          np_types=np_types)
+
+      problem.compile(
+          entry_point_name='main',
+          fun_to_benchmark_name=fun_name,
+          compile_time_problem_sizes_dict=compile_time_problem_sizes_dict,
+          transform=expert)
+
+      problem.run(
+          n_iters=n_iters,
+          entry_point_name='main',
+          runtime_problem_sizes_dict=runtime_problem_sizes_dict)
+
+
+if __name__ == '__main__':
+  main()
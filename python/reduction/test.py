@@ -63,6 +63,44 @@ def main():
             entry_point_name='reduction_2d_main',
             runtime_problem_sizes_dict=runtime_problem_sizes_dict)
 
+  # N-D reductions over various dimension subsets.
+  nd_problem_list = [
+      ([48, 16], [0]),
+      ([49, 17], [1]),
+      ([8, 12, 16], [2]),
+      ([8, 12, 16], [0, 2]),
+      ([9, 13, 17], [1, 2]),
+  ]
+  nd_keys = ['M', 'N', 'K']
+  for np_types in [[np.float32, np.float32]]:
+    for problem_sizes, reduction_dims in nd_problem_list:
+      rank = len(problem_sizes)
+      compile_time_problem_sizes_dict = {
+          k: v for k, v in zip(nd_keys[:rank], problem_sizes)
+      }
+      runtime_problem_sizes_dict = compile_time_problem_sizes_dict
+      # Init printing.
+      print(
+          f'\n###############################################################\n'
+          f'Problem size {compile_time_problem_sizes_dict}\n'
+          f'Reduction dimensions {reduction_dims}\n'
+          f'Problem types {np_types}')
+      problem = ProblemInstance(
+          problem_definition=ReductionNDProblem(rank, reduction_dims),
+          problem_sizes_keys=nd_keys[:rank],
+          np_types=np_types)
+
+      problem.compile(
+          entry_point_name='reduction_nd_main',
+          fun_to_benchmark_name='reduction_nd_on_tensors',
+          compile_time_problem_sizes_dict=compile_time_problem_sizes_dict,
+          transform=expert_no_tiling)
+
+      problem.run(
+          n_iters=n_iters,
+          entry_point_name='reduction_nd_main',
+          runtime_problem_sizes_dict=runtime_problem_sizes_dict)
+
 
 if __name__ == '__main__':
   main()
@@ -0,0 +1,105 @@
+// RUN: mlir-proto-opt -linalg-comprehensive-module-bufferize %s | FileCheck %s
+
+// CHECK-LABEL: func @sort_in_place
+//  CHECK-SAME:   %[[A:[a-zA-Z0-9]*]]: memref<?xf32
+//   CHECK-NOT:   memref.alloc
+//       CHECK:   linalg_ext.sort
+//  CHECK-SAME:     outs(%[[A]] : memref<?xf32
+//   CHECK-NOT:   memref.copy
+func @sort_in_place(%arg0 : tensor<?xf32> {linalg.inplaceable = true})
+    -> tensor<?xf32> {
+  %sorted = linalg_ext.sort
+      dimension(0)
+      outs(%arg0 : tensor<?xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %0 = arith.cmpf olt, %lhs, %rhs : f32
+        linalg_ext.yield %0 : i1
+      } -> tensor<?xf32>
+  return %sorted : tensor<?xf32>
+}
+
+
+// The output of reverse is not read, its buffer is written without a copy.
+// CHECK-LABEL: func @reverse_into_init
+//  CHECK-SAME:   %[[A:[a-zA-Z0-9]*]]: memref<?x?xf32
+//  CHECK-SAME:   %[[B:[a-zA-Z0-9]*]]: memref<?x?xf32
+//   CHECK-NOT:   memref.alloc
+//       CHECK:   linalg_ext.reverse
+//  CHECK-SAME:     ins(%[[A]] : memref<?x?xf32
+//  CHECK-SAME:     outs(%[[B]] : memref<?x?xf32
+func @reverse_into_init(%arg0 : tensor<?x?xf32>,
+                        %init : tensor<?x?xf32> {linalg.inplaceable = true})
+    -> tensor<?x?xf32> {
+  %reverse = linalg_ext.reverse
+      dimensions(dense<0> : tensor<1xi64>)
+      ins(%arg0 : tensor<?x?xf32>)
+      outs(%init : tensor<?x?xf32>) : tensor<?x?xf32>
+  return %reverse : tensor<?x?xf32>
+}
+
+// The accumulator seeds the scan and is copied into a new buffer when it is
+// not inplaceable, the output is not read and is written without a copy.
+// CHECK-LABEL: func @scan_reads_accumulator
+//  CHECK-SAME:   %[[IN:[a-zA-Z0-9]*]]: memref<?x?xf32
+//  CHECK-SAME:   %[[OUT:[a-zA-Z0-9]*]]: memref<?x?xf32
+//  CHECK-SAME:   %[[ACC:[a-zA-Z0-9]*]]: memref<?xf32
+//       CHECK:   %[[ACC_BUF:.*]] = memref.alloc
+//       CHECK:   memref.copy %[[ACC]], %[[ACC_BUF]]
+//   CHECK-NOT:   memref.copy
+//       CHECK:   linalg_ext.scan
+//  CHECK-SAME:     ins(%[[IN]] : memref<?x?xf32
+//  CHECK-SAME:     outs(%[[OUT]], %[[ACC_BUF]] : memref<?x?xf32
+func @scan_reads_accumulator(
+    %input : tensor<?x?xf32>,
+    %output : tensor<?x?xf32> {linalg.inplaceable = true},
+    %acc : tensor<?xf32>) -> tensor<?x?xf32> {
+  %scan:2 = linalg_ext.scan
+      dimension(1) inclusive(true)
+      ins(%input : tensor<?x?xf32>)
+      outs(%output, %acc : tensor<?x?xf32>, tensor<?xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %0 = arith.addf %lhs, %rhs : f32
+        linalg_ext.yield %0 : f32
+      } -> tensor<?x?xf32>, tensor<?xf32>
+  return %scan#0 : tensor<?x?xf32>
+}
+
+// CHECK-LABEL: func @gather_into_init
+//  CHECK-SAME:   %[[SOURCE:[a-zA-Z0-9]*]]: memref<?x?xf32
+//  CHECK-SAME:   %[[INDICES:[a-zA-Z0-9]*]]: memref<?x1xi32
+//  CHECK-SAME:   %[[OUT:[a-zA-Z0-9]*]]: memref<?x?xf32
+//   CHECK-NOT:   memref.alloc
+//       CHECK:   linalg_ext.gather
+//  CHECK-SAME:     ins(%[[SOURCE]], %[[INDICES]] : memref<?x?xf32
+//  CHECK-SAME:     outs(%[[OUT]] : memref<?x?xf32
+func @gather_into_init(%source : tensor<?x?xf32>, %indices : tensor<?x1xi32>,
+                       %output : tensor<?x?xf32> {linalg.inplaceable = true})
+    -> tensor<?x?xf32> {
+  %0 = linalg_ext.gather
+      ins(%source, %indices : tensor<?x?xf32>, tensor<?x1xi32>)
+      outs(%output : tensor<?x?xf32>) : tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+
+// CHECK-LABEL: func @scatter_in_place
+//  CHECK-SAME:   %[[UPDATES:[a-zA-Z0-9]*]]: memref<?x?xf32
+//  CHECK-SAME:   %[[INDICES:[a-zA-Z0-9]*]]: memref<?x1xi32
+//  CHECK-SAME:   %[[ORIGINAL:[a-zA-Z0-9]*]]: memref<?x?xf32
+//   CHECK-NOT:   memref.alloc
+//       CHECK:   linalg_ext.scatter
+//  CHECK-SAME:     ins(%[[UPDATES]], %[[INDICES]] : memref<?x?xf32
+//  CHECK-SAME:     outs(%[[ORIGINAL]] : memref<?x?xf32
+//   CHECK-NOT:   memref.copy
+func @scatter_in_place(
+    %updates : tensor<?x?xf32>, %indices : tensor<?x1xi32>,
+    %original : tensor<?x?xf32> {linalg.inplaceable = true})
+    -> tensor<?x?xf32> {
+  %0 = linalg_ext.scatter
+      ins(%updates, %indices : tensor<?x?xf32>, tensor<?x1xi32>)
+      outs(%original : tensor<?x?xf32>) {
+      ^bb0(%update: f32, %orig: f32):
+        %1 = arith.addf %update, %orig : f32
+        linalg_ext.yield %1 : f32
+      } -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
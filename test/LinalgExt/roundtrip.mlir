@@ -25,3 +25,127 @@ func @reverse_2d_tensor(%arg0 : tensor<?x?xf32>) -> tensor<?x?xf32> {
       outs(%init : tensor<?x?xf32>) : tensor<?x?xf32>
   return %reverse : tensor<?x?xf32>
 }
+
+// CHECK-LABEL: func @sort_2d_tensor
+//       CHECK:   linalg_ext.sort
+//  CHECK-SAME:     dimension(1)
+//  CHECK-SAME:     outs(%{{.*}}, %{{.*}} : tensor<?x?xf32>, tensor<?x?xi32>)
+//       CHECK:     arith.cmpf ogt
+//       CHECK:     linalg_ext.yield %{{.*}} : i1
+func @sort_2d_tensor(%keys : tensor<?x?xf32>, %values : tensor<?x?xi32>)
+    -> (tensor<?x?xf32>, tensor<?x?xi32>) {
+  %sorted:2 = linalg_ext.sort
+      dimension(1)
+      outs(%keys, %values : tensor<?x?xf32>, tensor<?x?xi32>) {
+      ^bb0(%lhs_key: f32, %rhs_key: f32, %lhs_value: i32, %rhs_value: i32):
+        %0 = arith.cmpf ogt, %lhs_key, %rhs_key : f32
+        linalg_ext.yield %0 : i1
+      } -> tensor<?x?xf32>, tensor<?x?xi32>
+  return %sorted#0, %sorted#1 : tensor<?x?xf32>, tensor<?x?xi32>
+}
+
+// CHECK-LABEL: func @scan_2d_tensor
+//       CHECK:   linalg_ext.scan
+//  CHECK-SAME:     dimension(1) inclusive(true)
+//  CHECK-SAME:     ins(%{{.*}} : tensor<?x?xf32>)
+//  CHECK-SAME:     outs(%{{.*}}, %{{.*}} : tensor<?x?xf32>, tensor<?xf32>)
+//       CHECK:     arith.addf
+//       CHECK:     linalg_ext.yield %{{.*}} : f32
+func @scan_2d_tensor(%input : tensor<?x?xf32>, %output : tensor<?x?xf32>,
+                     %acc : tensor<?xf32>) -> (tensor<?x?xf32>, tensor<?xf32>) {
+  %scan:2 = linalg_ext.scan
+      dimension(1) inclusive(true)
+      ins(%input : tensor<?x?xf32>)
+      outs(%output, %acc : tensor<?x?xf32>, tensor<?xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %0 = arith.addf %lhs, %rhs : f32
+        linalg_ext.yield %0 : f32
+      } -> tensor<?x?xf32>, tensor<?xf32>
+  return %scan#0, %scan#1 : tensor<?x?xf32>, tensor<?xf32>
+}
+
+// CHECK-LABEL: func @scatter_2d_tensor
+//       CHECK:   linalg_ext.scatter
+//  CHECK-SAME:     ins(%{{.*}}, %{{.*}} : tensor<?x64xf32>, tensor<?x1xi32>)
+//  CHECK-SAME:     outs(%{{.*}} : tensor<?x64xf32>)
+//       CHECK:     arith.addf
+//       CHECK:     linalg_ext.yield %{{.*}} : f32
+func @scatter_2d_tensor(%updates : tensor<?x64xf32>, %indices : tensor<?x1xi32>,
+                        %original : tensor<?x64xf32>) -> tensor<?x64xf32> {
+  %0 = linalg_ext.scatter
+      ins(%updates, %indices : tensor<?x64xf32>, tensor<?x1xi32>)
+      outs(%original : tensor<?x64xf32>) {
+      ^bb0(%update: f32, %orig: f32):
+        %1 = arith.addf %update, %orig : f32
+        linalg_ext.yield %1 : f32
+      } -> tensor<?x64xf32>
+  return %0 : tensor<?x64xf32>
+}
+
+// CHECK-LABEL: func @gather_2d_tensor
+//       CHECK:   linalg_ext.gather
+//  CHECK-SAME:     ins(%{{.*}}, %{{.*}} : tensor<?x64xf32>, tensor<?x1xindex>)
+//  CHECK-SAME:     outs(%{{.*}} : tensor<?x64xf32>) : tensor<?x64xf32>
+func @gather_2d_tensor(%source : tensor<?x64xf32>, %indices : tensor<?x1xindex>,
+                       %output : tensor<?x64xf32>) -> tensor<?x64xf32> {
+  %0 = linalg_ext.gather
+      ins(%source, %indices : tensor<?x64xf32>, tensor<?x1xindex>)
+      outs(%output : tensor<?x64xf32>) : tensor<?x64xf32>
+  return %0 : tensor<?x64xf32>
+}
+
+// CHECK-LABEL: func @topk_2d_tensor
+//       CHECK:   linalg_ext.topk
+//  CHECK-SAME:     dimension(1)
+//  CHECK-SAME:     ins(%{{.*}} : tensor<?x?xf32>)
+//  CHECK-SAME:     outs(%{{.*}}, %{{.*}} : tensor<?x10xf32>, tensor<?x10xi32>)
+//       CHECK:     arith.cmpf ogt
+//       CHECK:     linalg_ext.yield %{{.*}} : i1
+func @topk_2d_tensor(%values : tensor<?x?xf32>, %out_values : tensor<?x10xf32>,
+                     %out_indices : tensor<?x10xi32>)
+    -> (tensor<?x10xf32>, tensor<?x10xi32>) {
+  %0:2 = linalg_ext.topk
+      dimension(1)
+      ins(%values : tensor<?x?xf32>)
+      outs(%out_values, %out_indices : tensor<?x10xf32>, tensor<?x10xi32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %1 = arith.cmpf ogt, %lhs, %rhs : f32
+        linalg_ext.yield %1 : i1
+      } -> tensor<?x10xf32>, tensor<?x10xi32>
+  return %0#0, %0#1 : tensor<?x10xf32>, tensor<?x10xi32>
+}
+
+// The comparator may also take the indices of the compared elements.
+// CHECK-LABEL: func @topk_indexed_comparator
+//       CHECK:   linalg_ext.topk
+//       CHECK:     ^bb0(%{{.*}}: f32, %{{.*}}: f32, %[[LHS_INDEX:.*]]: i32, %[[RHS_INDEX:.*]]: i32):
+//       CHECK:     arith.cmpi slt, %[[LHS_INDEX]], %[[RHS_INDEX]] : i32
+func @topk_indexed_comparator(%values : tensor<?x?xf32>,
+                              %out_values : tensor<?x10xf32>,
+                              %out_indices : tensor<?x10xi32>)
+    -> (tensor<?x10xf32>, tensor<?x10xi32>) {
+  %0:2 = linalg_ext.topk
+      dimension(1)
+      ins(%values : tensor<?x?xf32>)
+      outs(%out_values, %out_indices : tensor<?x10xf32>, tensor<?x10xi32>) {
+      ^bb0(%lhs: f32, %rhs: f32, %lhs_index: i32, %rhs_index: i32):
+        %1 = arith.cmpi slt, %lhs_index, %rhs_index : i32
+        linalg_ext.yield %1 : i1
+      } -> tensor<?x10xf32>, tensor<?x10xi32>
+  return %0#0, %0#1 : tensor<?x10xf32>, tensor<?x10xi32>
+}
+
+// CHECK-LABEL: func @fft_2d_tensor
+//       CHECK:   linalg_ext.fft
+//  CHECK-SAME:     ins(%{{.*}} : index)
+//  CHECK-SAME:     outs(%{{.*}}, %{{.*}} : tensor<?x16xf32>, tensor<?x16xf32>)
+//  CHECK-SAME:     : tensor<?x16xf32>, tensor<?x16xf32>
+func @fft_2d_tensor(%real : tensor<?x16xf32>, %imag : tensor<?x16xf32>)
+    -> (tensor<?x16xf32>, tensor<?x16xf32>) {
+  %stage = arith.constant 2 : index
+  %0:2 = linalg_ext.fft
+      ins(%stage : index)
+      outs(%real, %imag : tensor<?x16xf32>, tensor<?x16xf32>)
+      : tensor<?x16xf32>, tensor<?x16xf32>
+  return %0#0, %0#1 : tensor<?x16xf32>, tensor<?x16xf32>
+}
@@ -12,3 +12,302 @@ func @reverse_1d_tensor(%arg0 : tensor<?x?xf32>) -> tensor<?x?xf32> {
       outs(%init : tensor<?x?xf32>) : tensor<?x?xf32>
   return %reverse : tensor<?x?xf32>
 }
+
+// The sorted dimension is never tiled, each tile sorts full rows.
+// CHECK-LABEL: func @sort_2d_tensor
+//       CHECK:   scf.for
+//   CHECK-NOT:   scf.for
+//       CHECK:     tensor.extract_slice %{{.*}}[%{{.*}}, 0] [%{{.*}}, %{{.*}}] [1, 1]
+//       CHECK:     tensor.extract_slice %{{.*}}[%{{.*}}, 0] [%{{.*}}, %{{.*}}] [1, 1]
+//       CHECK:     linalg_ext.sort
+//  CHECK-SAME:       dimension(1)
+//       CHECK:     tensor.insert_slice
+//       CHECK:     tensor.insert_slice
+func @sort_2d_tensor(%keys : tensor<?x?xf32>, %values : tensor<?x?xi32>)
+    -> (tensor<?x?xf32>, tensor<?x?xi32>) {
+  %sorted:2 = linalg_ext.sort
+      dimension(1)
+      outs(%keys, %values : tensor<?x?xf32>, tensor<?x?xi32>) {
+      ^bb0(%lhs_key: f32, %rhs_key: f32, %lhs_value: i32, %rhs_value: i32):
+        %0 = arith.cmpf ogt, %lhs_key, %rhs_key : f32
+        linalg_ext.yield %0 : i1
+      } -> tensor<?x?xf32>, tensor<?x?xi32>
+  return %sorted#0, %sorted#1 : tensor<?x?xf32>, tensor<?x?xi32>
+}
+
+// The parallel dimension is tiled by 2, the scanned dimension by 4 into a
+// two-phase scan.
+// CHECK-LABEL: func @scan_2d_tensor
+//       CHECK:   scf.for
+//       CHECK:     %[[NEUTRAL:.*]] = linalg.fill
+//       CHECK:     %[[PHASE1:.*]]:2 = scf.for
+//       CHECK:       linalg_ext.scan
+//  CHECK-SAME:         dimension(1) inclusive(true)
+//  CHECK-SAME:         outs(%{{.*}}, %[[NEUTRAL]] :
+//       CHECK:     %[[CARRIES:.*]]:2 = linalg_ext.scan
+//  CHECK-SAME:       dimension(1) inclusive(false)
+//  CHECK-SAME:       ins(%[[PHASE1]]#1 :
+//       CHECK:     scf.for
+//       CHECK:       tensor.extract_slice %[[CARRIES]]#0
+//       CHECK:       linalg.generic
+//       CHECK:         arith.addf
+//       CHECK:         linalg.yield
+func @scan_2d_tensor(%input : tensor<?x?xf32>, %output : tensor<?x?xf32>,
+                     %acc : tensor<?xf32>) -> (tensor<?x?xf32>, tensor<?xf32>) {
+  %scan:2 = linalg_ext.scan
+      dimension(1) inclusive(true)
+      ins(%input : tensor<?x?xf32>)
+      outs(%output, %acc : tensor<?x?xf32>, tensor<?xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %0 = arith.addf %lhs, %rhs : f32
+        linalg_ext.yield %0 : f32
+      } -> tensor<?x?xf32>, tensor<?xf32>
+  return %scan#0, %scan#1 : tensor<?x?xf32>, tensor<?xf32>
+}
+
+// The tiles of an integer and-scan start from all ones, the neutral element
+// shared with the Linalg reductions.
+// CHECK-LABEL: func @scan_and_2d_tensor
+//       CHECK:   %[[ONES:.*]] = arith.constant -1 : i32
+//       CHECK:   linalg.fill(%[[ONES]]
+//       CHECK:   linalg_ext.scan
+//       CHECK:     arith.andi
+func @scan_and_2d_tensor(%input : tensor<?x?xi32>, %output : tensor<?x?xi32>,
+                         %acc : tensor<?xi32>)
+    -> (tensor<?x?xi32>, tensor<?xi32>) {
+  %scan:2 = linalg_ext.scan
+      dimension(1) inclusive(true)
+      ins(%input : tensor<?x?xi32>)
+      outs(%output, %acc : tensor<?x?xi32>, tensor<?xi32>) {
+      ^bb0(%lhs: i32, %rhs: i32):
+        %0 = arith.andi %lhs, %rhs : i32
+        linalg_ext.yield %0 : i32
+      } -> tensor<?x?xi32>, tensor<?xi32>
+  return %scan#0, %scan#1 : tensor<?x?xi32>, tensor<?xi32>
+}
+
+// Scatter tiles update the loop-carried original in order.
+// CHECK-LABEL: func @scatter_2d_tensor
+//  CHECK-SAME:   %[[ORIGINAL:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//       CHECK:   scf.for {{.*}} iter_args(%[[ARG0:.*]] = %[[ORIGINAL]])
+//       CHECK:     scf.for {{.*}} iter_args(%[[ARG1:.*]] = %[[ARG0]])
+//       CHECK:       %[[DEST:.*]] = tensor.extract_slice %[[ARG1]][0, %{{.*}}]
+//       CHECK:       %[[SCATTER:.*]] = linalg_ext.scatter
+//  CHECK-SAME:         outs(%[[DEST]] : tensor<?x?xf32>)
+//       CHECK:       tensor.insert_slice %[[SCATTER]] into %[[ARG1]][0, %{{.*}}]
+func @scatter_2d_tensor(%updates : tensor<?x?xf32>, %indices : tensor<?x1xi32>,
+                        %original : tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %0 = linalg_ext.scatter
+      ins(%updates, %indices : tensor<?x?xf32>, tensor<?x1xi32>)
+      outs(%original : tensor<?x?xf32>) {
+      ^bb0(%update: f32, %orig: f32):
+        %1 = arith.addf %update, %orig : f32
+        linalg_ext.yield %1 : f32
+      } -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+
+// CHECK-LABEL: func @gather_2d_tensor
+//       CHECK:   scf.for
+//       CHECK:     scf.for
+//       CHECK:       tensor.extract_slice %{{.*}}[0, %{{.*}}]
+//       CHECK:       tensor.extract_slice %{{.*}}[%{{.*}}, 0] [%{{.*}}, 1]
+//       CHECK:       linalg_ext.gather
+//       CHECK:       tensor.insert_slice
+func @gather_2d_tensor(%source : tensor<?x?xf32>, %indices : tensor<?x1xi32>,
+                       %output : tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %0 = linalg_ext.gather
+      ins(%source, %indices : tensor<?x?xf32>, tensor<?x1xi32>)
+      outs(%output : tensor<?x?xf32>) : tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+
+// The parallel dimension is tiled by 2, the selected dimension is split into
+// tiles of 4 whose top-k are merged. The tiles start from padding candidates
+// with index -1, which lose ties against real elements.
+// CHECK-LABEL: func @topk_2d_tensor
+//       CHECK:   scf.for
+//   CHECK-DAG:     %[[LAST:.*]] = arith.constant 0xFF800000 : f32
+//   CHECK-DAG:     %[[PAD:.*]] = arith.constant -1 : i32
+//       CHECK:     %[[CANDIDATES:.*]] = linalg.fill(%[[LAST]]
+//       CHECK:     %[[PAD_INDICES:.*]] = linalg.fill(%[[PAD]]
+//       CHECK:     %[[PARTIAL:.*]]:2 = scf.for
+//       CHECK:       linalg_ext.topk
+//  CHECK-SAME:         outs(%[[CANDIDATES]], %[[PAD_INDICES]] : tensor<?x10xf32>, tensor<?x10xi32>)
+//       CHECK:         ^bb0(%[[LHS:.*]]: f32, %[[RHS:.*]]: f32, %[[LHS_INDEX:.*]]: i32, %[[RHS_INDEX:.*]]: i32):
+//       CHECK:         %[[BEFORE:.*]] = arith.cmpf ogt, %[[LHS]], %[[RHS]]
+//       CHECK:         %[[AFTER:.*]] = arith.cmpf ogt, %[[RHS]], %[[LHS]]
+//       CHECK:         arith.cmpi eq, %[[BEFORE]], %[[AFTER]]
+//       CHECK:         %[[LHS_REAL:.*]] = arith.cmpi ne, %[[LHS_INDEX]]
+//       CHECK:         arith.cmpi ne, %[[RHS_INDEX]]
+//       CHECK:         %[[TIE:.*]] = arith.andi
+//       CHECK:         %[[ORDER:.*]] = select %[[TIE]], %[[LHS_REAL]], %[[BEFORE]]
+//       CHECK:         linalg_ext.yield %[[ORDER]]
+//       CHECK:       arith.index_cast
+//       CHECK:       linalg.generic
+//       CHECK:         arith.cmpi eq
+//       CHECK:         arith.addi
+//       CHECK:         select
+//       CHECK:     linalg_ext.topk
+//  CHECK-SAME:       ins(%[[PARTIAL]]#0, %[[PARTIAL]]#1 :
+//       CHECK:       ^bb0(%{{.*}}: f32, %{{.*}}: f32, %{{.*}}: i32, %{{.*}}: i32):
+//       CHECK:       select
+func @topk_2d_tensor(%values : tensor<?x?xf32>, %out_values : tensor<?x10xf32>,
+                     %out_indices : tensor<?x10xi32>)
+    -> (tensor<?x10xf32>, tensor<?x10xi32>) {
+  %0:2 = linalg_ext.topk
+      dimension(1)
+      ins(%values : tensor<?x?xf32>)
+      outs(%out_values, %out_indices : tensor<?x10xf32>, tensor<?x10xi32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %1 = arith.cmpf ogt, %lhs, %rhs : f32
+        linalg_ext.yield %1 : i1
+      } -> tensor<?x10xf32>, tensor<?x10xi32>
+  return %0#0, %0#1 : tensor<?x10xf32>, tensor<?x10xi32>
+}
+
+// Every tile transforms full rows.
+// CHECK-LABEL: func @fft_2d_tensor
+//       CHECK:   scf.for
+//   CHECK-NOT:   scf.for
+//       CHECK:     tensor.extract_slice %{{.*}}[%{{.*}}, 0] [%{{.*}}, 16] [1, 1]
+//       CHECK:     tensor.extract_slice %{{.*}}[%{{.*}}, 0] [%{{.*}}, 16] [1, 1]
+//       CHECK:     %[[FFT:.*]]:2 = linalg_ext.fft
+//   CHECK-DAG:     tensor.cast %[[FFT]]#0 : tensor<?x16xf32> to tensor<?x?xf32>
+//   CHECK-DAG:     tensor.cast %[[FFT]]#1 : tensor<?x16xf32> to tensor<?x?xf32>
+//       CHECK:     tensor.insert_slice
+func @fft_2d_tensor(%real : tensor<?x16xf32>, %imag : tensor<?x16xf32>)
+    -> (tensor<?x16xf32>, tensor<?x16xf32>) {
+  %stage = arith.constant 2 : index
+  %0:2 = linalg_ext.fft
+      ins(%stage : index)
+      outs(%real, %imag : tensor<?x16xf32>, tensor<?x16xf32>)
+      : tensor<?x16xf32>, tensor<?x16xf32>
+  return %0#0, %0#1 : tensor<?x16xf32>, tensor<?x16xf32>
+}
+
+// Elementwise and fill producers are computed tile by tile in the loops of
+// the reverse.
+// CHECK-LABEL: func @fuse_producers_into_reverse
+//       CHECK:   scf.for
+//       CHECK:     scf.for
+//   CHECK-DAG:       %[[ADD:.*]] = linalg.generic
+//   CHECK-DAG:       %[[FILL:.*]] = linalg.fill
+//       CHECK:       linalg_ext.reverse
+//  CHECK-SAME:         ins(%[[ADD]] : tensor<?x?xf32>)
+//  CHECK-SAME:         outs(%[[FILL]] : tensor<?x?xf32>)
+func @fuse_producers_into_reverse(%arg0 : tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %cst = arith.constant 0.0 : f32
+  %d0 = tensor.dim %arg0, %c0 : tensor<?x?xf32>
+  %d1 = tensor.dim %arg0, %c1 : tensor<?x?xf32>
+  %init = linalg.init_tensor [%d0, %d1] : tensor<?x?xf32>
+  %add = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%arg0 : tensor<?x?xf32>) outs(%init : tensor<?x?xf32>) {
+      ^bb0(%a: f32, %b: f32):
+        %0 = arith.addf %a, %a : f32
+        linalg.yield %0 : f32
+      } -> tensor<?x?xf32>
+  %fill = linalg.fill(%cst, %init) : f32, tensor<?x?xf32> -> tensor<?x?xf32>
+  %reverse = linalg_ext.reverse
+      dimensions(dense<0> : tensor<1xi64>)
+      ins(%add : tensor<?x?xf32>)
+      outs(%fill : tensor<?x?xf32>) : tensor<?x?xf32>
+  return %reverse : tensor<?x?xf32>
+}
+
+// A reverse consumed by the tile loop of a linalg op is computed tile by tile
+// in that loop instead of being tiled on its own.
+// CHECK-LABEL: func @fuse_reverse_into_consumer_loop
+//       CHECK:   scf.for
+//   CHECK-NOT:     scf.for
+//       CHECK:     %[[REV:.*]] = linalg_ext.reverse
+//  CHECK-SAME:       {__internal_linalg_transform__ = "tiled"}
+//       CHECK:     linalg.generic
+//  CHECK-SAME:       ins(%[[REV]] : tensor<?x?xf32>)
+func @fuse_reverse_into_consumer_loop(
+    %arg0 : tensor<?x?xf32>, %init : tensor<?x?xf32>, %out : tensor<?x?xf32>)
+    -> tensor<?x?xf32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %d0 = tensor.dim %out, %c0 : tensor<?x?xf32>
+  %d1 = tensor.dim %out, %c1 : tensor<?x?xf32>
+  %reverse = linalg_ext.reverse
+      dimensions(dense<1> : tensor<1xi64>)
+      ins(%arg0 : tensor<?x?xf32>)
+      outs(%init : tensor<?x?xf32>) : tensor<?x?xf32>
+  %0 = scf.for %i = %c0 to %d0 step %c8 iter_args(%acc = %out)
+      -> (tensor<?x?xf32>) {
+    %size = affine.min affine_map<(d0)[s0] -> (8, -d0 + s0)>(%i)[%d0]
+    %rev_tile = tensor.extract_slice %reverse[%i, 0] [%size, %d1] [1, 1]
+        : tensor<?x?xf32> to tensor<?x?xf32>
+    %acc_tile = tensor.extract_slice %acc[%i, 0] [%size, %d1] [1, 1]
+        : tensor<?x?xf32> to tensor<?x?xf32>
+    %add = linalg.generic {
+        indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                         affine_map<(d0, d1) -> (d0, d1)>],
+        iterator_types = ["parallel", "parallel"]}
+        ins(%rev_tile : tensor<?x?xf32>) outs(%acc_tile : tensor<?x?xf32>) {
+        ^bb0(%a: f32, %b: f32):
+          %1 = arith.addf %a, %b : f32
+          linalg.yield %1 : f32
+        } -> tensor<?x?xf32>
+    %ins = tensor.insert_slice %add into %acc[%i, 0] [%size, %d1] [1, 1]
+        : tensor<?x?xf32> into tensor<?x?xf32>
+    scf.yield %ins : tensor<?x?xf32>
+  }
+  return %0 : tensor<?x?xf32>
+}
+
+// A sort consumed by the tile loop of a linalg op that tiles the sorted
+// dimension is not computed in that loop, it is tiled on its own.
+// CHECK-LABEL: func @no_fuse_sort_into_loop_over_sorted_dim
+//       CHECK:   %[[SORTED:.*]] = scf.for
+//       CHECK:     linalg_ext.sort
+//  CHECK-SAME:       dimension(1)
+//       CHECK:   scf.for
+//   CHECK-NOT:     linalg_ext.sort
+//       CHECK:     tensor.extract_slice %[[SORTED]]
+//       CHECK:     linalg.generic
+func @no_fuse_sort_into_loop_over_sorted_dim(
+    %keys : tensor<?x?xf32>, %out : tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %d0 = tensor.dim %out, %c0 : tensor<?x?xf32>
+  %d1 = tensor.dim %out, %c1 : tensor<?x?xf32>
+  %sorted = linalg_ext.sort
+      dimension(1)
+      outs(%keys : tensor<?x?xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %1 = arith.cmpf ogt, %lhs, %rhs : f32
+        linalg_ext.yield %1 : i1
+      } -> tensor<?x?xf32>
+  %0 = scf.for %j = %c0 to %d1 step %c8 iter_args(%acc = %out)
+      -> (tensor<?x?xf32>) {
+    %size = affine.min affine_map<(d0)[s0] -> (8, -d0 + s0)>(%j)[%d1]
+    %sorted_tile = tensor.extract_slice %sorted[0, %j] [%d0, %size] [1, 1]
+        : tensor<?x?xf32> to tensor<?x?xf32>
+    %acc_tile = tensor.extract_slice %acc[0, %j] [%d0, %size] [1, 1]
+        : tensor<?x?xf32> to tensor<?x?xf32>
+    %add = linalg.generic {
+        indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                         affine_map<(d0, d1) -> (d0, d1)>],
+        iterator_types = ["parallel", "parallel"]}
+        ins(%sorted_tile : tensor<?x?xf32>)
+        outs(%acc_tile : tensor<?x?xf32>) {
+        ^bb0(%a: f32, %b: f32):
+          %1 = arith.addf %a, %b : f32
+          linalg.yield %1 : f32
+        } -> tensor<?x?xf32>
+    %ins = tensor.insert_slice %add into %acc[0, %j] [%d0, %size] [1, 1]
+        : tensor<?x?xf32> into tensor<?x?xf32>
+    scf.yield %ins : tensor<?x?xf32>
+  }
+  return %0 : tensor<?x?xf32>
+}
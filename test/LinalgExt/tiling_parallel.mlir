@@ -0,0 +1,108 @@
+// RUN: mlir-proto-opt -linalg-ext-tiling="tile-sizes=2,4 loop-type=tiled_loop" %s | FileCheck %s --check-prefix=TILED
+// RUN: mlir-proto-opt -linalg-ext-tiling="tile-sizes=2,4 loop-type=parallel" %s | FileCheck %s --check-prefix=PARALLEL
+// RUN: mlir-proto-opt -linalg-ext-tiling="tile-sizes=2,4 loop-type=for" %s | FileCheck %s --check-prefix=FOR
+
+// The reversed tile is created in the loop body on the output of the loop.
+// TILED-LABEL: func @reverse_2d_tensor
+//  TILED-SAME:   %[[IN:[a-zA-Z0-9]*]]: tensor<?x?xf32>
+//  TILED-SAME:   %[[OUT:[a-zA-Z0-9]*]]: tensor<?x?xf32>
+//       TILED:   %[[RES:.*]] = linalg.tiled_loop (%[[I:.*]], %[[J:.*]]) =
+//  TILED-SAME:     outs (%[[OUT_:.*]] = %[[OUT]]: tensor<?x?xf32>)
+//  TILED-SAME:     iterators["parallel", "parallel"]
+//       TILED:     %[[IN_TILE:.*]] = tensor.extract_slice %[[IN]][%[[I]], %[[J]]]
+//       TILED:     %[[OUT_TILE:.*]] = tensor.extract_slice %[[OUT_]]
+//       TILED:     %[[REV:.*]] = linalg_ext.reverse
+//  TILED-SAME:       {__internal_linalg_transform__ = "tiled"}
+//  TILED-SAME:       ins(%[[IN_TILE]] : tensor<?x?xf32>)
+//  TILED-SAME:       outs(%[[OUT_TILE]] : tensor<?x?xf32>)
+//       TILED:     %[[INS:.*]] = tensor.insert_slice %[[REV]] into %[[OUT_]]
+//       TILED:     linalg.yield %[[INS]]
+//       TILED:   return %[[RES]]
+func @reverse_2d_tensor(%arg0 : tensor<?x?xf32>, %init : tensor<?x?xf32>)
+    -> tensor<?x?xf32> {
+  %reverse = linalg_ext.reverse
+      dimensions(dense<0> : tensor<1xi64>)
+      ins(%arg0 : tensor<?x?xf32>)
+      outs(%init : tensor<?x?xf32>) : tensor<?x?xf32>
+  return %reverse : tensor<?x?xf32>
+}
+
+// scf.parallel cannot carry tensor results, ops on tensors are not tiled.
+// PARALLEL-LABEL: func @reverse_2d_tensor
+//   PARALLEL-NOT:   scf.parallel
+//       PARALLEL:   linalg_ext.reverse
+
+// Only the parallel dimension of the sort is tiled.
+// TILED-LABEL: func @sort_2d_memref
+//       TILED:   linalg.tiled_loop (%[[I:.*]]) =
+//  TILED-SAME:     iterators["parallel"]
+//       TILED:     memref.subview
+//       TILED:     linalg_ext.sort
+//  TILED-SAME:       dimension(1)
+//       TILED:     linalg.yield
+//
+// PARALLEL-LABEL: func @sort_2d_memref
+//  PARALLEL-SAME:   %[[KEYS:[a-zA-Z0-9]*]]: memref<?x?xf32>
+//       PARALLEL:   scf.parallel (%[[I:.*]]) =
+//       PARALLEL:     %[[TILE:.*]] = memref.subview %[[KEYS]][%[[I]], 0]
+//       PARALLEL:     linalg_ext.sort
+//  PARALLEL-SAME:       dimension(1)
+//  PARALLEL-SAME:       outs(%[[TILE]] :
+//   PARALLEL-NOT:   linalg_ext.sort
+//
+// On buffers the scf.for nest carries no values.
+// FOR-LABEL: func @sort_2d_memref
+//  FOR-SAME:   %[[KEYS:[a-zA-Z0-9]*]]: memref<?x?xf32>
+//       FOR:   scf.for %[[I:[a-zA-Z0-9]*]] =
+//   FOR-NOT:     iter_args
+//       FOR:     %[[TILE:.*]] = memref.subview %[[KEYS]][%[[I]], 0]
+//       FOR:     linalg_ext.sort
+//  FOR-SAME:       dimension(1)
+//  FOR-SAME:       outs(%[[TILE]] :
+//   FOR-NOT:     scf.yield %
+//       FOR:   return
+func @sort_2d_memref(%keys : memref<?x?xf32>) {
+  linalg_ext.sort
+      dimension(1)
+      outs(%keys : memref<?x?xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %0 = arith.cmpf ogt, %lhs, %rhs : f32
+        linalg_ext.yield %0 : i1
+      }
+  return
+}
+
+// The tile loops of the first and the last phase of the split scan are
+// parallel tiled loops, only the scan of the tile totals is sequential.
+// TILED-LABEL: func @scan_2d_tensor
+//       TILED:   linalg.tiled_loop
+//       TILED:     %[[PHASE1:.*]]:2 = linalg.tiled_loop
+//  TILED-SAME:       iterators["parallel"]
+//       TILED:       linalg_ext.scan
+//  TILED-SAME:         inclusive(true)
+//       TILED:       linalg.yield
+//       TILED:     %[[CARRIES:.*]]:2 = linalg_ext.scan
+//  TILED-SAME:       inclusive(false)
+//  TILED-SAME:       ins(%[[PHASE1]]#1 :
+//       TILED:     linalg.tiled_loop
+//  TILED-SAME:       iterators["parallel"]
+//       TILED:       tensor.extract_slice %[[CARRIES]]#0
+//       TILED:       linalg.generic
+//       TILED:       linalg.yield
+//
+// PARALLEL-LABEL: func @scan_2d_tensor
+//   PARALLEL-NOT:   scf.parallel
+//       PARALLEL:   linalg_ext.scan
+//   PARALLEL-NOT:   linalg_ext.scan
+func @scan_2d_tensor(%input : tensor<?x?xf32>, %output : tensor<?x?xf32>,
+                     %acc : tensor<?xf32>) -> (tensor<?x?xf32>, tensor<?xf32>) {
+  %scan:2 = linalg_ext.scan
+      dimension(1) inclusive(true)
+      ins(%input : tensor<?x?xf32>)
+      outs(%output, %acc : tensor<?x?xf32>, tensor<?xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %0 = arith.addf %lhs, %rhs : f32
+        linalg_ext.yield %0 : f32
+      } -> tensor<?x?xf32>, tensor<?xf32>
+  return %scan#0, %scan#1 : tensor<?x?xf32>, tensor<?xf32>
+}
@@ -0,0 +1,126 @@
+// RUN: mlir-proto-opt -linalg-ext-vectorization %s | FileCheck %s
+
+// CHECK-LABEL: func @sort_1x4_tensor
+//   CHECK-DAG:   %[[C0:.*]] = arith.constant 0 : index
+//       CHECK:   %[[V:.*]] = vector.transfer_read %{{.*}}[%[[C0]], %[[C0]]]
+//  CHECK-SAME:     tensor<1x4xf32>, vector<4xf32>
+// 4 stages with one comparison per direction each.
+// CHECK-COUNT-4: vector.shuffle
+//       CHECK:   vector.transfer_write %{{.*}}, %{{.*}}[%[[C0]], %[[C0]]]
+//  CHECK-SAME:     vector<4xf32>, tensor<1x4xf32>
+//   CHECK-NOT:   linalg_ext.sort
+func @sort_1x4_tensor(%keys : tensor<1x4xf32>) -> tensor<1x4xf32> {
+  %sorted = linalg_ext.sort
+      dimension(1)
+      outs(%keys : tensor<1x4xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %0 = arith.cmpf olt, %lhs, %rhs : f32
+        linalg_ext.yield %0 : i1
+      } -> tensor<1x4xf32>
+  return %sorted : tensor<1x4xf32>
+}
+
+// Rows larger than the sorting network threshold are not vectorized.
+// CHECK-LABEL: func @sort_1x64_tensor
+//       CHECK:   linalg_ext.sort
+func @sort_1x64_tensor(%keys : tensor<1x64xf32>) -> tensor<1x64xf32> {
+  %sorted = linalg_ext.sort
+      dimension(1)
+      outs(%keys : tensor<1x64xf32>) {
+      ^bb0(%lhs: f32, %rhs: f32):
+        %0 = arith.cmpf olt, %lhs, %rhs : f32
+        linalg_ext.yield %0 : i1
+      } -> tensor<1x64xf32>
+  return %sorted : tensor<1x64xf32>
+}
+
+// CHECK-LABEL: func @gather_rows
+//       CHECK:   scf.for %[[B:.*]] = {{.*}} iter_args(%[[OUT:.*]] =
+//       CHECK:     %[[IDX:.*]] = tensor.extract %{{.*}}[%[[B]], %{{.*}}] : tensor<?x1xi32>
+//       CHECK:     %[[POS:.*]] = arith.index_cast %[[IDX]] : i32 to index
+//       CHECK:     %[[ROW:.*]] = vector.transfer_read %{{.*}}[%[[POS]], %{{.*}}]
+//  CHECK-SAME:       tensor<?x64xf32>, vector<64xf32>
+//       CHECK:     vector.transfer_write %[[ROW]], %[[OUT]][%[[B]], %{{.*}}]
+//   CHECK-NOT:   linalg_ext.gather
+func @gather_rows(%source : tensor<?x64xf32>, %indices : tensor<?x1xi32>,
+                  %output : tensor<?x64xf32>) -> tensor<?x64xf32> {
+  %0 = linalg_ext.gather
+      ins(%source, %indices : tensor<?x64xf32>, tensor<?x1xi32>)
+      outs(%output : tensor<?x64xf32>) : tensor<?x64xf32>
+  return %0 : tensor<?x64xf32>
+}
+
+// CHECK-LABEL: func @scatter_add_rows
+//       CHECK:   scf.for %[[B:.*]] = {{.*}} iter_args(%[[ORIG:.*]] =
+//       CHECK:     %[[POS:.*]] = tensor.extract %{{.*}}[%[[B]], %{{.*}}] : tensor<?x1xindex>
+//       CHECK:     %[[UPDATE:.*]] = vector.transfer_read %{{.*}}[%[[B]], %{{.*}}]
+//       CHECK:     %[[OLD:.*]] = vector.transfer_read %[[ORIG]][%[[POS]], %{{.*}}]
+//       CHECK:     %[[NEW:.*]] = arith.addf %[[UPDATE]], %[[OLD]] : vector<16xf32>
+//       CHECK:     vector.transfer_write %[[NEW]], %[[ORIG]][%[[POS]], %{{.*}}]
+//   CHECK-NOT:   linalg_ext.scatter
+func @scatter_add_rows(%updates : tensor<?x16xf32>,
+                       %indices : tensor<?x1xindex>,
+                       %original : tensor<128x16xf32>) -> tensor<128x16xf32> {
+  %0 = linalg_ext.scatter
+      ins(%updates, %indices : tensor<?x16xf32>, tensor<?x1xindex>)
+      outs(%original : tensor<128x16xf32>) {
+      ^bb0(%update: f32, %orig: f32):
+        %1 = arith.addf %update, %orig : f32
+        linalg_ext.yield %1 : f32
+      } -> tensor<128x16xf32>
+  return %0 : tensor<128x16xf32>
+}
+
+// Stage 2 of an 8-point FFT: butterflies (0, 2), (1, 3), (4, 6) and (5, 7).
+// CHECK-LABEL: func @fft_stage_2
+//   CHECK-DAG:   %[[WRE:.*]] = arith.constant dense<[1.000000e+00, {{.*}}, 1.000000e+00, {{.*}}]> : vector<4xf32>
+//   CHECK-DAG:   %[[RE:.*]] = vector.transfer_read %{{.*}} : tensor<1x8xf32>, vector<8xf32>
+//   CHECK-DAG:   %[[IM:.*]] = vector.transfer_read %{{.*}} : tensor<1x8xf32>, vector<8xf32>
+//       CHECK:   %[[URE:.*]] = vector.shuffle %[[RE]], %[[RE]] [0, 1, 4, 5]
+//       CHECK:   vector.shuffle %[[IM]], %[[IM]] [0, 1, 4, 5]
+//       CHECK:   %[[VRE:.*]] = vector.shuffle %[[RE]], %[[RE]] [2, 3, 6, 7]
+//       CHECK:   arith.mulf %[[WRE]], %[[VRE]] : vector<4xf32>
+//       CHECK:   %[[LRE:.*]] = arith.addf %[[URE]]
+//       CHECK:   %[[HRE:.*]] = arith.subf %[[URE]]
+//       CHECK:   vector.shuffle %[[LRE]], %[[HRE]] [0, 1, 4, 5, 2, 3, 6, 7]
+//       CHECK:   vector.transfer_write
+//       CHECK:   vector.transfer_write
+//   CHECK-NOT:   linalg_ext.fft
+func @fft_stage_2(%real : tensor<1x8xf32>, %imag : tensor<1x8xf32>)
+    -> (tensor<1x8xf32>, tensor<1x8xf32>) {
+  %stage = arith.constant 2 : index
+  %0:2 = linalg_ext.fft
+      ins(%stage : index)
+      outs(%real, %imag : tensor<1x8xf32>, tensor<1x8xf32>)
+      : tensor<1x8xf32>, tensor<1x8xf32>
+  return %0#0, %0#1 : tensor<1x8xf32>, tensor<1x8xf32>
+}
+
+// CHECK-LABEL: func @reverse_row
+//       CHECK:   %[[V:.*]] = vector.transfer_read %{{.*}} : tensor<1x8xf32>, vector<8xf32>
+//       CHECK:   %[[R:.*]] = vector.shuffle %[[V]], %[[V]] [7, 6, 5, 4, 3, 2, 1, 0]
+//       CHECK:   vector.transfer_write %[[R]], %{{.*}} : vector<8xf32>, tensor<1x8xf32>
+//   CHECK-NOT:   linalg_ext.reverse
+func @reverse_row(%input : tensor<1x8xf32>) -> tensor<1x8xf32> {
+  %init = linalg.init_tensor [1, 8] : tensor<1x8xf32>
+  %0 = linalg_ext.reverse
+      dimensions(dense<[0, 1]> : tensor<2xi64>)
+      ins(%input : tensor<1x8xf32>)
+      outs(%init : tensor<1x8xf32>) : tensor<1x8xf32>
+  return %0 : tensor<1x8xf32>
+}
+
+// CHECK-LABEL: func @reverse_inner_dim
+//       CHECK:   %[[V:.*]] = vector.transfer_read %{{.*}} : tensor<2x4xi32>, vector<2x4xi32>
+//       CHECK:   %[[T:.*]] = vector.transpose %[[V]], [1, 0]
+//       CHECK:   %[[R:.*]] = vector.shuffle %[[T]], %[[T]] [3, 2, 1, 0]
+//       CHECK:   %[[B:.*]] = vector.transpose %[[R]], [1, 0]
+//       CHECK:   vector.transfer_write %[[B]]
+func @reverse_inner_dim(%input : tensor<2x4xi32>) -> tensor<2x4xi32> {
+  %init = linalg.init_tensor [2, 4] : tensor<2x4xi32>
+  %0 = linalg_ext.reverse
+      dimensions(dense<1> : tensor<1xi64>)
+      ins(%input : tensor<2x4xi32>)
+      outs(%init : tensor<2x4xi32>) : tensor<2x4xi32>
+  return %0 : tensor<2x4xi32>
+}
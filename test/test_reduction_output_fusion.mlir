@@ -3,6 +3,16 @@
 // RUN: -canonicalize -cse |\
 // RUN: FileCheck %s
 
+// RUN: mlir-proto-opt %s\
+// RUN: -linalg-tensor-codegen-driver="anchor-func=reduce_max anchor-op=linalg.generic fuse-fill-into-reduction tile-sizes=24,16" \
+// RUN: -canonicalize -cse |\
+// RUN: FileCheck %s --check-prefix=MAX
+
+// RUN: mlir-proto-opt %s\
+// RUN: -linalg-tensor-codegen-driver="anchor-func=reduce_sum_and_sum_of_squares anchor-op=linalg.generic fuse-fill-into-reduction tile-sizes=24,16" \
+// RUN: -canonicalize -cse |\
+// RUN: FileCheck %s --check-prefix=MULTI
+
 func @reduce(%input: tensor<2400x1600xf32>, %output: tensor<2400xf32>) -> tensor<2400xf32> {
   %cst = arith.constant 0.000000e+00 : f32
   %c0 = arith.constant 0 : index
@@ -31,3 +41,73 @@ func @reduce(%input: tensor<2400x1600xf32>, %output: tensor<2400xf32>) -> tensor
 // CHECK-NEXT:     linalg.generic
 // CHECK:          linalg.generic
 // CHECK:          tensor.insert_slice
+
+func @reduce_max(%input: tensor<2400x1600xf32>, %output: tensor<2400xf32>) -> tensor<2400xf32> {
+  %cst = arith.constant 1.000000e+00 : f32
+
+  %fill = linalg.fill(%cst, %output) : f32, tensor<2400xf32> -> tensor<2400xf32>
+  %max = linalg.generic {
+    indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                     affine_map<(d0, d1) -> (d0)>],
+    iterator_types = ["parallel", "reduction"]}
+    ins(%input : tensor<2400x1600xf32>)
+    outs(%fill : tensor<2400xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %sq = arith.mulf %in, %in : f32
+    %m = maxf %sq, %out : f32
+    linalg.yield %m : f32
+  } -> tensor<2400xf32>
+  return %max : tensor<2400xf32>
+}
+
+// MAX-LABEL: func @reduce_max
+// MAX-DAG:      %[[INIT:.*]] = arith.constant 1.000000e+00 : f32
+// MAX-DAG:      %[[NEUTRAL:.*]] = arith.constant 0xFF800000 : f32
+// MAX:          linalg.fill(%[[INIT]]
+// MAX:          scf.for
+// MAX:            scf.for
+// MAX:              linalg.init_tensor [24]
+// MAX-NEXT:         linalg.fill(%[[NEUTRAL]]
+// MAX-NEXT:         linalg.generic
+// MAX:                arith.mulf
+// MAX:                maxf
+// MAX:              linalg.generic
+// MAX-NOT:            arith.mulf
+// MAX:                maxf
+// MAX:              tensor.insert_slice
+
+func @reduce_sum_and_sum_of_squares(%input: tensor<2400x1600xf32>,
+                                    %sum: tensor<2400xf32>,
+                                    %sum_sq: tensor<2400xf32>)
+    -> (tensor<2400xf32>, tensor<2400xf32>) {
+  %cst = arith.constant 0.000000e+00 : f32
+
+  %fill_sum = linalg.fill(%cst, %sum) : f32, tensor<2400xf32> -> tensor<2400xf32>
+  %fill_sum_sq = linalg.fill(%cst, %sum_sq) : f32, tensor<2400xf32> -> tensor<2400xf32>
+  %res:2 = linalg.generic {
+    indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                     affine_map<(d0, d1) -> (d0)>,
+                     affine_map<(d0, d1) -> (d0)>],
+    iterator_types = ["parallel", "reduction"]}
+    ins(%input : tensor<2400x1600xf32>)
+    outs(%fill_sum, %fill_sum_sq : tensor<2400xf32>, tensor<2400xf32>) {
+  ^bb0(%in: f32, %out: f32, %out_sq: f32):
+    %add = arith.addf %in, %out : f32
+    %sq = arith.mulf %in, %in : f32
+    %add_sq = arith.addf %sq, %out_sq : f32
+    linalg.yield %add, %add_sq : f32, f32
+  } -> (tensor<2400xf32>, tensor<2400xf32>)
+  return %res#0, %res#1 : tensor<2400xf32>, tensor<2400xf32>
+}
+
+// MULTI-LABEL: func @reduce_sum_and_sum_of_squares
+// MULTI:          linalg.fill
+// MULTI:          linalg.fill
+// MULTI:          scf.for
+// MULTI:            scf.for
+// MULTI-COUNT-2:      linalg.fill
+// MULTI:              linalg.generic
+// MULTI-SAME:           ins(%{{.*}} : tensor<24x16xf32>)
+// MULTI-SAME:           outs(%{{.*}}, %{{.*}} : tensor<24xf32>, tensor<24xf32>)
+// MULTI-COUNT-2:      linalg.generic
+// MULTI-COUNT-2:      tensor.insert_slice
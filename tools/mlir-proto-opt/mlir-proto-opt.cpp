@@ -11,8 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "CAPI.h"
-//#include "include/LinalgExt/LinalgExtDialect.h"
-//#include "include/LinalgExt/Passes.h"
+#include "include/LinalgExt/BufferizableOpInterfaceImpl.h"
+#include "include/LinalgExt/LinalgExtDialect.h"
+#include "include/LinalgExt/Passes.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/SourceMgr.h"
@@ -49,12 +50,13 @@ int main(int argc, char **argv) {
   llvm::InitLLVM y(argc, argv);
   registerAllPasses();
   ireeLlvmSandboxRegisterPasses();
-  //linalg_ext::registerLinalgExtPasses();
+  linalg_ext::registerLinalgExtPasses();
 
   DialectRegistry registry;
   registerAllDialects(registry);
   registerIreeDialects(registry);
-  //registry.insert<linalg_ext::LinalgExtDialect>();
+  registry.insert<linalg_ext::LinalgExtDialect>();
+  linalg_ext::registerBufferizableOpInterfaceExternalModels(registry);
 
   return failed(MlirOptMain(argc, argv, "MLIR modular optimizer driver\n",
                             registry,